@@ -69,6 +69,10 @@ struct hb_buffer_t {
   hb_glyph_info_t     *out_info;
   hb_glyph_position_t *pos;
 
+  /* Whether info and pos point into caller-supplied storage,
+   * set by hb_buffer_set_storage(), instead of being heap-allocated. */
+  bool storage_external;
+
   inline hb_glyph_info_t &cur (unsigned int i = 0) { return info[idx + i]; }
   inline hb_glyph_info_t cur (unsigned int i = 0) const { return info[idx + i]; }
 
@@ -152,6 +156,22 @@ struct hb_buffer_t {
     idx++;
   }
 
+  /* Copies count glyphs at idx to output and advances idx past them. */
+  inline void
+  next_glyphs (unsigned int count)
+  {
+    if (have_output)
+    {
+      if (unlikely (out_info != info || out_len != idx)) {
+	if (unlikely (!make_room_for (count, count))) return;
+	memmove (out_info + out_len, info + idx, count * sizeof (out_info[0]));
+      }
+      out_len += count;
+    }
+
+    idx += count;
+  }
+
   /* Advance idx without copying to output. */
   inline void skip_glyph (void) { idx++; }
 
@@ -107,8 +107,30 @@ hb_buffer_t::enlarge (unsigned int size)
   if (unlikely (_hb_unsigned_int_mul_overflows (new_allocated, sizeof (info[0]))))
     goto done;
 
-  new_pos = (hb_glyph_position_t *) realloc (pos, new_allocated * sizeof (pos[0]));
-  new_info = (hb_glyph_info_t *) realloc (info, new_allocated * sizeof (info[0]));
+  if (unlikely (storage_external))
+  {
+    /* Outgrew the caller's storage; move to the heap. */
+    new_pos = (hb_glyph_position_t *) malloc (new_allocated * sizeof (pos[0]));
+    new_info = (hb_glyph_info_t *) malloc (new_allocated * sizeof (info[0]));
+    if (likely (new_pos && new_info))
+    {
+      memcpy (new_pos, pos, allocated * sizeof (pos[0]));
+      memcpy (new_info, info, allocated * sizeof (info[0]));
+      storage_external = false;
+    }
+    else
+    {
+      free (new_pos);
+      free (new_info);
+      new_pos = NULL;
+      new_info = NULL;
+    }
+  }
+  else
+  {
+    new_pos = (hb_glyph_position_t *) realloc (pos, new_allocated * sizeof (pos[0]));
+    new_info = (hb_glyph_info_t *) realloc (info, new_allocated * sizeof (info[0]));
+  }
 
 done:
   if (unlikely (!new_pos || !new_info))
@@ -754,8 +776,11 @@ hb_buffer_destroy (hb_buffer_t *buffer)
 
   hb_unicode_funcs_destroy (buffer->unicode);
 
-  free (buffer->info);
-  free (buffer->pos);
+  if (!buffer->storage_external)
+  {
+    free (buffer->info);
+    free (buffer->pos);
+  }
 
   free (buffer);
 }
@@ -1136,6 +1161,69 @@ hb_buffer_pre_allocate (hb_buffer_t *buffer, unsigned int size)
   return buffer->ensure (size);
 }
 
+/**
+ * hb_buffer_set_storage:
+ * @buffer: an empty buffer.
+ * @storage: (allow-none): memory for the buffer's glyph arrays, or %NULL.
+ * @storage_size: size of @storage in bytes.
+ *
+ * Makes @buffer keep its glyph information and positions in @storage
+ * instead of allocating them, so that a caller shaping many runs can
+ * supply the memory from its own arena.  hb_buffer_get_glyph_infos()
+ * and hb_buffer_get_glyph_positions() then point into @storage.
+ *
+ * Each glyph takes up to 40 bytes of @storage.  If the buffer contents
+ * outgrow it, the buffer moves them to memory of its own and stops
+ * using @storage.  @storage must stay valid until then, until @buffer
+ * is destroyed, or until this function is called again; passing %NULL
+ * makes the buffer allocate its arrays itself again.
+ *
+ * Return value: %FALSE if @buffer is not empty or @storage is too small
+ * to hold a single glyph, %TRUE otherwise.
+ *
+ * Since: 0.9.41
+ **/
+hb_bool_t
+hb_buffer_set_storage (hb_buffer_t  *buffer,
+		       void         *storage,
+		       unsigned int  storage_size)
+{
+  if (unlikely (hb_object_is_inert (buffer) || buffer->len))
+    return false;
+
+  /* The glyph arrays only hold 32-bit fields. */
+  unsigned int misalignment = (4 - (uintptr_t) storage % 4) % 4;
+  unsigned int count = 0;
+  if (storage && storage_size > misalignment)
+    count = (storage_size - misalignment) / (sizeof (buffer->info[0]) +
+					     sizeof (buffer->pos[0]));
+  if (storage && !count)
+    return false;
+
+  if (!buffer->storage_external)
+  {
+    free (buffer->info);
+    free (buffer->pos);
+  }
+
+  if (storage)
+  {
+    buffer->info = (hb_glyph_info_t *) ((char *) storage + misalignment);
+    buffer->pos = (hb_glyph_position_t *) (buffer->info + count);
+  }
+  else
+  {
+    buffer->info = NULL;
+    buffer->pos = NULL;
+  }
+  buffer->allocated = count;
+  buffer->storage_external = storage != NULL;
+  buffer->out_info = buffer->info;
+  buffer->in_error = false;
+
+  return true;
+}
+
 /**
  * hb_buffer_allocation_successful:
  * @buffer: a buffer.
@@ -1351,6 +1439,16 @@ hb_buffer_guess_segment_properties (hb_buffer_t *buffer)
   buffer->guess_segment_properties ();
 }
 
+static inline void
+set_unicode_info (hb_glyph_info_t *info, hb_codepoint_t codepoint, unsigned int cluster)
+{
+  /* Same as hb_buffer_t::add(). */
+  memset (info, 0, sizeof (*info));
+  info->codepoint = codepoint;
+  info->mask = 1;
+  info->cluster = cluster;
+}
+
 template <typename utf_t>
 static inline void
 hb_buffer_add_utf (hb_buffer_t  *buffer,
@@ -1399,12 +1497,32 @@ hb_buffer_add_utf (hb_buffer_t  *buffer,
 
   const T *next = text + item_offset;
   const T *end = next + item_length;
+  /* Decode in chunks of code units, making room for as many characters
+   * as each chunk has code units, and fill in info[] directly.  Runs of
+   * code units that each decode to themselves skip the decoder. */
   while (next < end)
   {
-    hb_codepoint_t u;
-    const T *old_next = next;
-    next = utf_t::next (next, end, &u, replacement);
-    buffer->add (u, old_next - (const T *) text);
+    const T *chunk_end = end - next > 64 ? next + 64 : end;
+    if (unlikely (!buffer->ensure (buffer->len + (chunk_end - next))))
+    {
+      next = end;
+      break;
+    }
+
+    hb_glyph_info_t *info = buffer->info + buffer->len;
+    while (next < chunk_end)
+    {
+      for (const T *run_end = utf_t::skip_trivial (next, chunk_end); next < run_end; next++)
+	set_unicode_info (info++, *next, next - text);
+      if (next == chunk_end)
+	break;
+
+      hb_codepoint_t u;
+      const T *old_next = next;
+      next = utf_t::next (next, end, &u, replacement);
+      set_unicode_info (info++, u, old_next - text);
+    }
+    buffer->len = info - buffer->info;
   }
 
   /* Add post-context */
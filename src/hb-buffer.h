@@ -214,6 +214,12 @@ hb_buffer_pre_allocate (hb_buffer_t  *buffer,
 		        unsigned int  size);
 
 
+/* Returns false if buffer is not empty or storage is too small */
+hb_bool_t
+hb_buffer_set_storage (hb_buffer_t  *buffer,
+		       void         *storage,
+		       unsigned int  storage_size);
+
 /* Returns false if allocation has failed before */
 hb_bool_t
 hb_buffer_allocation_successful (hb_buffer_t  *buffer);
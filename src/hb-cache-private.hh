@@ -36,18 +36,23 @@ template <unsigned int key_bits, unsigned int value_bits, unsigned int cache_bit
 struct hb_cache_t
 {
   ASSERT_STATIC (key_bits >= cache_bits);
-  ASSERT_STATIC (key_bits + value_bits - cache_bits < 8 * sizeof (unsigned int));
+  ASSERT_STATIC (key_bits + value_bits - cache_bits <= 8 * sizeof (unsigned int));
 
   inline void clear (void)
   {
     memset (values, 255, sizeof (values));
   }
 
+  /* A cleared slot has all bits set; the all-ones value is reserved
+   * so that such a slot never matches a key. */
   inline bool get (unsigned int key, unsigned int *value)
   {
+    if (unlikely (key >> key_bits))
+      return false;
     unsigned int k = key & ((1<<cache_bits)-1);
     unsigned int v = values[k];
-    if ((v >> value_bits) != (key >> cache_bits))
+    if ((v >> value_bits) != (key >> cache_bits) ||
+	(v & ((1<<value_bits)-1)) == ((1<<value_bits)-1))
       return false;
     *value = v & ((1<<value_bits)-1);
     return true;
@@ -55,7 +60,7 @@ struct hb_cache_t
 
   inline bool set (unsigned int key, unsigned int value)
   {
-    if (unlikely ((key >> key_bits) || (value >> value_bits)))
+    if (unlikely ((key >> key_bits) || value >= ((1<<value_bits)-1)))
       return false; /* Overflows */
     unsigned int k = key & ((1<<cache_bits)-1);
     unsigned int v = ((key>>cache_bits)<<value_bits) | value;
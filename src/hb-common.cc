@@ -192,11 +192,10 @@ lang_equal (hb_language_t  v1,
   return *p1 == canon_map[*p2];
 }
 
-#if 0
 static unsigned int
 lang_hash (const void *key)
 {
-  const unsigned char *p = key;
+  const unsigned char *p = (const unsigned char *) key;
   unsigned int h = 0;
   while (canon_map[*p])
     {
@@ -206,12 +205,10 @@ lang_hash (const void *key)
 
   return h;
 }
-#endif
 
 
 struct hb_language_item_t {
 
-  struct hb_language_item_t *next;
   hb_language_t lang;
 
   inline bool operator == (const char *s) const {
@@ -220,6 +217,8 @@ struct hb_language_item_t {
 
   inline hb_language_item_t & operator = (const char *s) {
     lang = (hb_language_t) strdup (s);
+    if (unlikely (!lang))
+      return *this;
     for (unsigned char *p = (unsigned char *) lang; *p; p++)
       *p = canon_map[*p];
 
@@ -230,52 +229,123 @@ struct hb_language_item_t {
 };
 
 
-/* Thread-safe lock-free language list */
+/* Thread-safe lock-free language table.
+ *
+ * Languages are interned in open-addressing hash tables with linear
+ * probing.  Slots only ever go from NULL to an item, so lookups never
+ * retry: they probe at most HB_LANGUAGE_MAX_PROBES slots per table.
+ * Should all of those be taken by other languages, the language goes
+ * in the next table, which is twice as large, and created on demand. */
+
+#define HB_LANGUAGE_TABLE_MIN_SIZE 256 /* Must be a power of two. */
+#define HB_LANGUAGE_MAX_PROBES 16
+
+struct hb_language_table_t {
+  hb_language_table_t *next;
+  unsigned int mask;
+  hb_language_item_t *items[1];
+};
 
-static hb_language_item_t *langs;
+static hb_language_table_t *langs;
+static hb_atomic_int_t langs_count;
 
 #ifdef HB_USE_ATEXIT
 static
 void free_langs (void)
 {
   while (langs) {
-    hb_language_item_t *next = langs->next;
-    langs->finish ();
+    hb_language_table_t *next = langs->next;
+    for (unsigned int i = 0; i <= langs->mask; i++)
+      if (langs->items[i]) {
+	langs->items[i]->finish ();
+	free (langs->items[i]);
+      }
     free (langs);
     langs = next;
   }
 }
 #endif
 
-static hb_language_item_t *
-lang_find_or_insert (const char *key)
+static hb_language_table_t *
+lang_table_get (hb_language_table_t **ptable, unsigned int size)
 {
-retry:
-  hb_language_item_t *first_lang = (hb_language_item_t *) hb_atomic_ptr_get (&langs);
+  hb_language_table_t *table = (hb_language_table_t *) hb_atomic_ptr_get (ptable);
+  if (likely (table))
+    return table;
 
-  for (hb_language_item_t *lang = first_lang; lang; lang = lang->next)
-    if (*lang == key)
-      return lang;
-
-  /* Not found; allocate one. */
-  hb_language_item_t *lang = (hb_language_item_t *) calloc (1, sizeof (hb_language_item_t));
-  if (unlikely (!lang))
+  table = (hb_language_table_t *) calloc (1, sizeof (hb_language_table_t) + (size - 1) * sizeof (table->items[0]));
+  if (unlikely (!table))
     return NULL;
-  lang->next = first_lang;
-  *lang = key;
+  table->mask = size - 1;
 
-  if (!hb_atomic_ptr_cmpexch (&langs, first_lang, lang)) {
-    lang->finish ();
-    free (lang);
-    goto retry;
+  if (!hb_atomic_ptr_cmpexch (ptable, NULL, table)) {
+    free (table);
+    table = (hb_language_table_t *) hb_atomic_ptr_get (ptable);
   }
-
 #ifdef HB_USE_ATEXIT
-  if (!first_lang)
+  else if (ptable == &langs)
     atexit (free_langs); /* First person registers atexit() callback. */
 #endif
 
-  return lang;
+  return table;
+}
+
+static hb_language_item_t *
+lang_find_or_insert (const char *key)
+{
+  hb_language_item_t *lang = NULL;
+
+  unsigned int h = lang_hash (key);
+  hb_language_table_t **ptable = &langs;
+  for (unsigned int size = HB_LANGUAGE_TABLE_MIN_SIZE; size; size <<= 1)
+  {
+    hb_language_table_t *table = lang_table_get (ptable, size);
+    if (unlikely (!table))
+      break;
+
+    for (unsigned int i = 0; i < HB_LANGUAGE_MAX_PROBES; i++)
+    {
+      hb_language_item_t **slot = &table->items[(h + i) & table->mask];
+      hb_language_item_t *item = (hb_language_item_t *) hb_atomic_ptr_get (slot);
+
+      if (!item)
+      {
+	/* Not found; allocate one and try to claim this slot. */
+	if (!lang) {
+	  lang = (hb_language_item_t *) calloc (1, sizeof (hb_language_item_t));
+	  if (unlikely (!lang))
+	    return NULL;
+	  *lang = key;
+	  if (unlikely (!lang->lang)) {
+	    free (lang);
+	    return NULL;
+	  }
+	}
+	if (hb_atomic_ptr_cmpexch (slot, NULL, lang)) {
+	  langs_count.inc ();
+	  return lang;
+	}
+	item = (hb_language_item_t *) hb_atomic_ptr_get (slot);
+      }
+
+      if (*item == key)
+      {
+	if (lang) {
+	  lang->finish ();
+	  free (lang);
+	}
+	return item;
+      }
+    }
+
+    ptable = &table->next;
+  }
+
+  if (lang) {
+    lang->finish ();
+    free (lang);
+  }
+  return NULL;
 }
 
 
@@ -329,6 +399,23 @@ hb_language_to_string (hb_language_t language)
   return language->s;
 }
 
+/**
+ * hb_language_get_count:
+ *
+ * Returns the number of distinct languages interned so far by
+ * hb_language_from_string().  Interned languages are never freed,
+ * so this is also a measure of the memory they use.
+ *
+ * Return value: number of interned languages.
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_language_get_count (void)
+{
+  return langs_count.get_unsafe ();
+}
+
 /**
  * hb_language_get_default:
  *
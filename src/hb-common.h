@@ -148,6 +148,9 @@ hb_language_to_string (hb_language_t language);
 hb_language_t
 hb_language_get_default (void);
 
+unsigned int
+hb_language_get_count (void);
+
 
 /* hb_script_t */
 
@@ -40,6 +40,8 @@
  * hb_face_t
  */
 
+#define HB_SHAPE_PLAN_CACHE_BUCKETS 256
+
 struct hb_face_t {
   hb_object_header_t header;
   ASSERT_POD ();
@@ -56,10 +58,25 @@ struct hb_face_t {
 
   struct hb_shaper_data_t shaper_data;
 
+  /* Shape-plan cache.  A lock-free hash table of singly-linked
+   * buckets; the bucket array is allocated on first insertion.
+   * Nodes are only ever prepended, and only freed with the face. */
   struct plan_node_t {
     hb_shape_plan_t *shape_plan;
+    unsigned int hash;
     plan_node_t *next;
-  } *shape_plans;
+  } **shape_plans;
+  unsigned int shape_plans_max; /* Zero means unlimited. */
+  struct plan_stats_t {
+    hb_atomic_int_t count;
+    hb_atomic_int_t hits;
+    hb_atomic_int_t misses;
+    hb_atomic_int_t dropped;
+  } shape_plans_stats;
+
+  /* Memory the OpenType layout may spend on native-endian copies of
+   * large Coverage and ClassDef tables.  Zero disables them. */
+  unsigned int layout_table_cache_budget;
 
 
   inline hb_blob_t *reference_table (hb_tag_t tag) const
@@ -64,6 +64,15 @@ const hb_face_t _hb_face_nil = {
   },
 
   NULL, /* shape_plans */
+  0,    /* shape_plans_max */
+  {
+    HB_ATOMIC_INT_INIT (0), /* count */
+    HB_ATOMIC_INT_INIT (0), /* hits */
+    HB_ATOMIC_INT_INIT (0), /* misses */
+    HB_ATOMIC_INT_INIT (0), /* dropped */
+  },
+
+  0,    /* layout_table_cache_budget */
 };
 
 
@@ -227,12 +236,17 @@ hb_face_destroy (hb_face_t *face)
 {
   if (!hb_object_destroy (face)) return;
 
-  for (hb_face_t::plan_node_t *node = face->shape_plans; node; )
+  if (face->shape_plans)
   {
-    hb_face_t::plan_node_t *next = node->next;
-    hb_shape_plan_destroy (node->shape_plan);
-    free (node);
-    node = next;
+    for (unsigned int i = 0; i < HB_SHAPE_PLAN_CACHE_BUCKETS; i++)
+      for (hb_face_t::plan_node_t *node = face->shape_plans[i]; node; )
+      {
+	hb_face_t::plan_node_t *next = node->next;
+	hb_shape_plan_destroy (node->shape_plan);
+	free (node);
+	node = next;
+      }
+    free (face->shape_plans);
   }
 
 #define HB_SHAPER_IMPLEMENT(shaper) HB_SHAPER_DATA_DESTROY(shaper, face);
@@ -469,6 +483,91 @@ hb_face_get_glyph_count (hb_face_t *face)
   return face->get_num_glyphs ();
 }
 
+/**
+ * hb_face_set_shape_plan_cache_limit:
+ * @face: a face.
+ * @max_plans: maximum number of shape plans to cache, or zero for no limit.
+ *
+ * Bounds the number of shape plans hb_shape_plan_create_cached() keeps
+ * for @face.  Once the limit is reached, new plans are still created,
+ * but are not added to the cache.  The limit is approximate when plans
+ * are being created from multiple threads concurrently.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_face_set_shape_plan_cache_limit (hb_face_t    *face,
+				    unsigned int  max_plans)
+{
+  if (face->immutable)
+    return;
+
+  face->shape_plans_max = max_plans;
+}
+
+/**
+ * hb_face_get_shape_plan_cache_stats:
+ * @face: a face.
+ * @num_plans: (out) (allow-none): number of plans currently cached.
+ * @hits: (out) (allow-none): number of lookups fulfilled from the cache.
+ * @misses: (out) (allow-none): number of lookups that created a new plan.
+ * @dropped: (out) (allow-none): number of new plans not cached because
+ *   the cache limit was reached.
+ *
+ * Reports shape-plan cache statistics for @face.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_face_get_shape_plan_cache_stats (hb_face_t    *face,
+				    unsigned int *num_plans, /* OUT */
+				    unsigned int *hits,      /* OUT */
+				    unsigned int *misses,    /* OUT */
+				    unsigned int *dropped    /* OUT */)
+{
+  if (num_plans) *num_plans = face->shape_plans_stats.count.get_unsafe ();
+  if (hits)      *hits      = face->shape_plans_stats.hits.get_unsafe ();
+  if (misses)    *misses    = face->shape_plans_stats.misses.get_unsafe ();
+  if (dropped)   *dropped   = face->shape_plans_stats.dropped.get_unsafe ();
+}
+
+/**
+ * hb_face_set_layout_table_cache_budget:
+ * @face: a face.
+ * @max_bytes: memory budget in bytes, or zero to disable.
+ *
+ * Allows the OpenType shaper to spend up to @max_bytes on copying the
+ * largest Coverage and ClassDef tables of the face's GSUB and GPOS
+ * tables into native-endian arrays indexed directly by glyph, instead
+ * of binary-searching them on every lookup.  The tables are chosen by
+ * size when the face's layout data is first loaded; the default is zero.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_face_set_layout_table_cache_budget (hb_face_t    *face,
+				       unsigned int  max_bytes)
+{
+  if (face->immutable)
+    return;
+
+  face->layout_table_cache_budget = max_bytes;
+}
+
+/**
+ * hb_face_get_layout_table_cache_budget:
+ * @face: a face.
+ *
+ * Return value: the budget set with hb_face_set_layout_table_cache_budget().
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_face_get_layout_table_cache_budget (hb_face_t *face)
+{
+  return face->layout_table_cache_budget;
+}
+
 void
 hb_face_t::load_num_glyphs (void) const
 {
@@ -111,6 +111,24 @@ hb_face_set_glyph_count (hb_face_t    *face,
 unsigned int
 hb_face_get_glyph_count (hb_face_t *face);
 
+void
+hb_face_set_shape_plan_cache_limit (hb_face_t    *face,
+				    unsigned int  max_plans);
+
+void
+hb_face_get_shape_plan_cache_stats (hb_face_t    *face,
+				    unsigned int *num_plans, /* OUT */
+				    unsigned int *hits,      /* OUT */
+				    unsigned int *misses,    /* OUT */
+				    unsigned int *dropped    /* OUT */);
+
+void
+hb_face_set_layout_table_cache_budget (hb_face_t    *face,
+				       unsigned int  max_bytes);
+
+unsigned int
+hb_face_get_layout_table_cache_budget (hb_face_t *face);
+
 
 HB_END_DECLS
 
@@ -32,6 +32,7 @@
 #include "hb-private.hh"
 
 #include "hb-object-private.hh"
+#include "hb-cache-private.hh"
 #include "hb-face-private.hh"
 #include "hb-shaper-private.hh"
 
@@ -53,8 +54,19 @@
   HB_FONT_FUNC_IMPLEMENT (glyph_contour_point) \
   HB_FONT_FUNC_IMPLEMENT (glyph_name) \
   HB_FONT_FUNC_IMPLEMENT (glyph_from_name) \
+  HB_FONT_FUNC_IMPLEMENT (glyphs) \
+  HB_FONT_FUNC_IMPLEMENT (glyph_h_advances) \
+  HB_FONT_FUNC_IMPLEMENT (glyph_v_advances) \
   /* ^--- Add new callbacks here */
 
+/* Steps through the strided arrays of the batch callbacks. */
+template <typename Type>
+static inline Type *
+hb_font_stride_next (Type *p, unsigned int stride)
+{
+  return (Type *) (void *) ((char *) p + stride);
+}
+
 struct hb_font_funcs_t {
   hb_object_header_t header;
   ASSERT_POD ();
@@ -84,6 +96,32 @@ struct hb_font_funcs_t {
 
 
 
+/*
+ * hb_font_cache_t
+ */
+
+/* Optional cache sitting in front of the get_glyph and get_glyph_h_advance
+ * callbacks.  Slots are single words, so concurrent readers see either a
+ * complete entry or a miss.  The counters are not atomic and as such are
+ * only approximate when the font is shared between threads. */
+struct hb_font_cache_t
+{
+  hb_cmap_cache_t cmap;
+  hb_advance_cache_t advance;
+
+  unsigned int cmap_hits;
+  unsigned int cmap_misses;
+  unsigned int advance_hits;
+  unsigned int advance_misses;
+
+  inline void clear (void)
+  {
+    cmap.clear ();
+    advance.clear ();
+  }
+};
+
+
 /*
  * hb_font_t
  */
@@ -107,12 +145,14 @@ struct hb_font_t {
   void              *user_data;
   hb_destroy_func_t  destroy;
 
+  hb_font_cache_t   *cache;
+
   struct hb_shaper_data_t shaper_data;
 
 
   /* Convert from font-space to user-space */
-  inline hb_position_t em_scale_x (int16_t v) { return em_scale (v, this->x_scale); }
-  inline hb_position_t em_scale_y (int16_t v) { return em_scale (v, this->y_scale); }
+  inline hb_position_t em_scale_x (int v) { return em_scale (v, this->x_scale); }
+  inline hb_position_t em_scale_y (int v) { return em_scale (v, this->y_scale); }
 
   /* Convert from parent-font user-space to our user-space */
   inline hb_position_t parent_scale_x_distance (hb_position_t v) {
@@ -154,6 +194,23 @@ struct hb_font_t {
 			      hb_codepoint_t *glyph)
   {
     *glyph = 0;
+    if (cache && !variation_selector)
+    {
+      unsigned int v;
+      if (cache->cmap.get (unicode, &v))
+      {
+	cache->cmap_hits++;
+	*glyph = v;
+	return true;
+      }
+      cache->cmap_misses++;
+      if (!klass->get.glyph (this, user_data,
+			     unicode, 0, glyph,
+			     klass->user_data.glyph))
+	return false;
+      cache->cmap.set (unicode, *glyph);
+      return true;
+    }
     return klass->get.glyph (this, user_data,
 			     unicode, variation_selector, glyph,
 			     klass->user_data.glyph);
@@ -161,6 +218,22 @@ struct hb_font_t {
 
   inline hb_position_t get_glyph_h_advance (hb_codepoint_t glyph)
   {
+    if (cache)
+    {
+      unsigned int v;
+      if (cache->advance.get (glyph, &v))
+      {
+	cache->advance_hits++;
+	return v;
+      }
+      cache->advance_misses++;
+      hb_position_t ret = klass->get.glyph_h_advance (this, user_data,
+						      glyph,
+						      klass->user_data.glyph_h_advance);
+      /* Negative and very large advances overflow the cache; just skip them. */
+      cache->advance.set (glyph, ret);
+      return ret;
+    }
     return klass->get.glyph_h_advance (this, user_data,
 				       glyph,
 				       klass->user_data.glyph_h_advance);
@@ -173,6 +246,46 @@ struct hb_font_t {
 				       klass->user_data.glyph_v_advance);
   }
 
+  /* Returns the number of leading characters that have a glyph. */
+  inline unsigned int get_glyphs (unsigned int count,
+				  const hb_codepoint_t *first_unicode,
+				  unsigned int unicode_stride,
+				  hb_codepoint_t *first_glyph,
+				  unsigned int glyph_stride)
+  {
+    return klass->get.glyphs (this, user_data,
+			      count,
+			      first_unicode, unicode_stride,
+			      first_glyph, glyph_stride,
+			      klass->user_data.glyphs);
+  }
+
+  inline void get_glyph_h_advances (unsigned int count,
+				    const hb_codepoint_t *first_glyph,
+				    unsigned int glyph_stride,
+				    hb_position_t *first_advance,
+				    unsigned int advance_stride)
+  {
+    klass->get.glyph_h_advances (this, user_data,
+				 count,
+				 first_glyph, glyph_stride,
+				 first_advance, advance_stride,
+				 klass->user_data.glyph_h_advances);
+  }
+
+  inline void get_glyph_v_advances (unsigned int count,
+				    const hb_codepoint_t *first_glyph,
+				    unsigned int glyph_stride,
+				    hb_position_t *first_advance,
+				    unsigned int advance_stride)
+  {
+    klass->get.glyph_v_advances (this, user_data,
+				 count,
+				 first_glyph, glyph_stride,
+				 first_advance, advance_stride,
+				 klass->user_data.glyph_v_advances);
+  }
+
   inline hb_bool_t get_glyph_h_origin (hb_codepoint_t glyph,
 				       hb_position_t *x, hb_position_t *y)
   {
@@ -402,7 +515,7 @@ struct hb_font_t {
   }
 
   private:
-  inline hb_position_t em_scale (int16_t v, int scale) { return (hb_position_t) (v * (int64_t) scale / face->get_upem ()); }
+  inline hb_position_t em_scale (int v, int scale) { return (hb_position_t) (v * (int64_t) scale / face->get_upem ()); }
 };
 
 #define HB_SHAPER_DATA_CREATE_FUNC_EXTRA_ARGS
@@ -215,6 +215,68 @@ hb_font_get_glyph_from_name_nil (hb_font_t *font,
   return false;
 }
 
+/* The batch callbacks default to looping over the single-glyph ones
+ * of the same font, such that setting just those is enough. */
+
+static unsigned int
+hb_font_get_glyphs_nil (hb_font_t *font,
+			void *font_data HB_UNUSED,
+			unsigned int count,
+			const hb_codepoint_t *first_unicode,
+			unsigned int unicode_stride,
+			hb_codepoint_t *first_glyph,
+			unsigned int glyph_stride,
+			void *user_data HB_UNUSED)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!font->get_glyph (*first_unicode, 0, first_glyph))
+      return i;
+
+    first_unicode = hb_font_stride_next (first_unicode, unicode_stride);
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+  }
+  return count;
+}
+
+static void
+hb_font_get_glyph_h_advances_nil (hb_font_t *font,
+				  void *font_data HB_UNUSED,
+				  unsigned int count,
+				  const hb_codepoint_t *first_glyph,
+				  unsigned int glyph_stride,
+				  hb_position_t *first_advance,
+				  unsigned int advance_stride,
+				  void *user_data HB_UNUSED)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    *first_advance = font->get_glyph_h_advance (*first_glyph);
+
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+    first_advance = hb_font_stride_next (first_advance, advance_stride);
+  }
+}
+
+static void
+hb_font_get_glyph_v_advances_nil (hb_font_t *font,
+				  void *font_data HB_UNUSED,
+				  unsigned int count,
+				  const hb_codepoint_t *first_glyph,
+				  unsigned int glyph_stride,
+				  hb_position_t *first_advance,
+				  unsigned int advance_stride,
+				  void *user_data HB_UNUSED)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    *first_advance = font->get_glyph_v_advance (*first_glyph);
+
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+    first_advance = hb_font_stride_next (first_advance, advance_stride);
+  }
+}
+
 
 static const hb_font_funcs_t _hb_font_funcs_nil = {
   HB_OBJECT_HEADER_STATIC,
@@ -636,6 +698,88 @@ hb_font_get_glyph_from_name (hb_font_t *font,
 }
 
 
+/**
+ * hb_font_get_glyphs:
+ * @font: a font.
+ * @count: number of characters.
+ * @first_unicode: first character.
+ * @unicode_stride: distance in bytes between consecutive characters.
+ * @first_glyph: (out): where to store the first glyph.
+ * @glyph_stride: distance in bytes between consecutive glyphs.
+ *
+ * Maps up to @count characters to glyphs in one call, stopping at the
+ * first character the font has no glyph for.
+ *
+ * Return value: the number of characters mapped.
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_font_get_glyphs (hb_font_t *font,
+		    unsigned int count,
+		    const hb_codepoint_t *first_unicode,
+		    unsigned int unicode_stride,
+		    hb_codepoint_t *first_glyph,
+		    unsigned int glyph_stride)
+{
+  return font->get_glyphs (count,
+			   first_unicode, unicode_stride,
+			   first_glyph, glyph_stride);
+}
+
+/**
+ * hb_font_get_glyph_h_advances:
+ * @font: a font.
+ * @count: number of glyphs.
+ * @first_glyph: first glyph.
+ * @glyph_stride: distance in bytes between consecutive glyphs.
+ * @first_advance: (out): where to store the first advance.
+ * @advance_stride: distance in bytes between consecutive advances.
+ *
+ * Fetches the horizontal advances of @count glyphs in one call.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_get_glyph_h_advances (hb_font_t *font,
+			      unsigned int count,
+			      const hb_codepoint_t *first_glyph,
+			      unsigned int glyph_stride,
+			      hb_position_t *first_advance,
+			      unsigned int advance_stride)
+{
+  font->get_glyph_h_advances (count,
+			      first_glyph, glyph_stride,
+			      first_advance, advance_stride);
+}
+
+/**
+ * hb_font_get_glyph_v_advances:
+ * @font: a font.
+ * @count: number of glyphs.
+ * @first_glyph: first glyph.
+ * @glyph_stride: distance in bytes between consecutive glyphs.
+ * @first_advance: (out): where to store the first advance.
+ * @advance_stride: distance in bytes between consecutive advances.
+ *
+ * Fetches the vertical advances of @count glyphs in one call.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_get_glyph_v_advances (hb_font_t *font,
+			      unsigned int count,
+			      const hb_codepoint_t *first_glyph,
+			      unsigned int glyph_stride,
+			      hb_position_t *first_advance,
+			      unsigned int advance_stride)
+{
+  font->get_glyph_v_advances (count,
+			      first_glyph, glyph_stride,
+			      first_advance, advance_stride);
+}
+
+
 /* A bit higher-level, and with fallback */
 
 /**
@@ -926,6 +1070,8 @@ hb_font_get_empty (void)
     NULL, /* user_data */
     NULL, /* destroy */
 
+    NULL, /* cache */
+
     {
 #define HB_SHAPER_IMPLEMENT(shaper) HB_SHAPER_DATA_INVALID,
 #include "hb-shaper-list.hh"
@@ -976,6 +1122,8 @@ hb_font_destroy (hb_font_t *font)
   hb_face_destroy (font->face);
   hb_font_funcs_destroy (font->klass);
 
+  free (font->cache);
+
   free (font);
 }
 
@@ -1121,6 +1269,9 @@ hb_font_set_funcs (hb_font_t         *font,
   font->klass = klass;
   font->user_data = font_data;
   font->destroy = destroy;
+
+  if (font->cache)
+    font->cache->clear ();
 }
 
 /**
@@ -1150,6 +1301,9 @@ hb_font_set_funcs_data (hb_font_t         *font,
 
   font->user_data = font_data;
   font->destroy = destroy;
+
+  if (font->cache)
+    font->cache->clear ();
 }
 
 
@@ -1173,6 +1327,9 @@ hb_font_set_scale (hb_font_t *font,
 
   font->x_scale = x_scale;
   font->y_scale = y_scale;
+
+  if (font->cache)
+    font->cache->advance.clear ();
 }
 
 /**
@@ -1214,6 +1371,9 @@ hb_font_set_ppem (hb_font_t *font,
 
   font->x_ppem = x_ppem;
   font->y_ppem = y_ppem;
+
+  if (font->cache)
+    font->cache->advance.clear ();
 }
 
 /**
@@ -1234,3 +1394,86 @@ hb_font_get_ppem (hb_font_t *font,
   if (x_ppem) *x_ppem = font->x_ppem;
   if (y_ppem) *y_ppem = font->y_ppem;
 }
+
+
+/**
+ * hb_font_set_cache_enabled:
+ * @font: a font.
+ * @enabled: whether to cache glyph and advance lookups.
+ *
+ * Enables or disables a small per-font cache in front of the
+ * get_glyph and get_glyph_h_advance font functions.  The cache is
+ * off by default; it is cleared whenever the font functions, scale,
+ * or ppem change.  Like the other setters this must be called before
+ * the font is shared between threads.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_set_cache_enabled (hb_font_t *font,
+			   hb_bool_t  enabled)
+{
+  if (font->immutable)
+    return;
+
+  if (!enabled)
+  {
+    free (font->cache);
+    font->cache = NULL;
+    return;
+  }
+
+  if (font->cache)
+    return;
+
+  hb_font_cache_t *cache = (hb_font_cache_t *) calloc (1, sizeof (hb_font_cache_t));
+  if (unlikely (!cache))
+    return;
+  cache->clear ();
+
+  font->cache = cache;
+}
+
+/**
+ * hb_font_get_cache_enabled:
+ * @font: a font.
+ *
+ * 
+ *
+ * Return value: whether the glyph and advance cache is enabled on @font.
+ *
+ * Since: 0.9.41
+ **/
+hb_bool_t
+hb_font_get_cache_enabled (hb_font_t *font)
+{
+  return font->cache != NULL;
+}
+
+/**
+ * hb_font_get_cache_stats:
+ * @font: a font.
+ * @glyph_hits: (out) (allow-none): number of get_glyph calls served from the cache.
+ * @glyph_misses: (out) (allow-none): number of get_glyph calls forwarded to the font functions.
+ * @advance_hits: (out) (allow-none): number of get_glyph_h_advance calls served from the cache.
+ * @advance_misses: (out) (allow-none): number of get_glyph_h_advance calls forwarded to the font functions.
+ *
+ * Fetches the hit / miss counters of the cache enabled with
+ * hb_font_set_cache_enabled().  The counters are not updated atomically
+ * and may be slightly off if the font is used from multiple threads.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_get_cache_stats (hb_font_t    *font,
+			 unsigned int *glyph_hits,
+			 unsigned int *glyph_misses,
+			 unsigned int *advance_hits,
+			 unsigned int *advance_misses)
+{
+  const hb_font_cache_t *cache = font->cache;
+  if (glyph_hits) *glyph_hits = cache ? cache->cmap_hits : 0;
+  if (glyph_misses) *glyph_misses = cache ? cache->cmap_misses : 0;
+  if (advance_hits) *advance_hits = cache ? cache->advance_hits : 0;
+  if (advance_misses) *advance_misses = cache ? cache->advance_misses : 0;
+}
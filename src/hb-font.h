@@ -137,6 +137,27 @@ typedef hb_bool_t (*hb_font_get_glyph_from_name_func_t) (hb_font_t *font, void *
 							 void *user_data);
 
 
+/* Batch variants; the arrays are walked with the given byte strides. */
+
+typedef unsigned int (*hb_font_get_glyphs_func_t) (hb_font_t *font, void *font_data,
+						   unsigned int count,
+						   const hb_codepoint_t *first_unicode,
+						   unsigned int unicode_stride,
+						   hb_codepoint_t *first_glyph,
+						   unsigned int glyph_stride,
+						   void *user_data);
+
+typedef void (*hb_font_get_glyph_advances_func_t) (hb_font_t *font, void *font_data,
+						   unsigned int count,
+						   const hb_codepoint_t *first_glyph,
+						   unsigned int glyph_stride,
+						   hb_position_t *first_advance,
+						   unsigned int advance_stride,
+						   void *user_data);
+typedef hb_font_get_glyph_advances_func_t hb_font_get_glyph_h_advances_func_t;
+typedef hb_font_get_glyph_advances_func_t hb_font_get_glyph_v_advances_func_t;
+
+
 /* func setters */
 
 /**
@@ -315,6 +336,57 @@ hb_font_funcs_set_glyph_from_name_func (hb_font_funcs_t *ffuncs,
 					hb_font_get_glyph_from_name_func_t func,
 					void *user_data, hb_destroy_func_t destroy);
 
+/**
+ * hb_font_funcs_set_glyphs_func:
+ * @ffuncs: font functions.
+ * @func: (closure user_data) (destroy destroy) (scope notified):
+ * @user_data:
+ * @destroy:
+ *
+ * Sets the batch variant of the glyph callback.  If unset, it
+ * calls the glyph callback for each character.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_funcs_set_glyphs_func (hb_font_funcs_t *ffuncs,
+			       hb_font_get_glyphs_func_t func,
+			       void *user_data, hb_destroy_func_t destroy);
+
+/**
+ * hb_font_funcs_set_glyph_h_advances_func:
+ * @ffuncs: font functions.
+ * @func: (closure user_data) (destroy destroy) (scope notified):
+ * @user_data:
+ * @destroy:
+ *
+ * Sets the batch variant of the glyph_h_advance callback.  If
+ * unset, it calls the glyph_h_advance callback for each glyph.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_funcs_set_glyph_h_advances_func (hb_font_funcs_t *ffuncs,
+					 hb_font_get_glyph_h_advances_func_t func,
+					 void *user_data, hb_destroy_func_t destroy);
+
+/**
+ * hb_font_funcs_set_glyph_v_advances_func:
+ * @ffuncs: font functions.
+ * @func: (closure user_data) (destroy destroy) (scope notified):
+ * @user_data:
+ * @destroy:
+ *
+ * Sets the batch variant of the glyph_v_advance callback.  If
+ * unset, it calls the glyph_v_advance callback for each glyph.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_font_funcs_set_glyph_v_advances_func (hb_font_funcs_t *ffuncs,
+					 hb_font_get_glyph_v_advances_func_t func,
+					 void *user_data, hb_destroy_func_t destroy);
+
 
 /* func dispatch */
 
@@ -365,6 +437,29 @@ hb_font_get_glyph_from_name (hb_font_t *font,
 			     const char *name, int len, /* -1 means nul-terminated */
 			     hb_codepoint_t *glyph);
 
+unsigned int
+hb_font_get_glyphs (hb_font_t *font,
+		    unsigned int count,
+		    const hb_codepoint_t *first_unicode,
+		    unsigned int unicode_stride,
+		    hb_codepoint_t *first_glyph,
+		    unsigned int glyph_stride);
+
+void
+hb_font_get_glyph_h_advances (hb_font_t *font,
+			      unsigned int count,
+			      const hb_codepoint_t *first_glyph,
+			      unsigned int glyph_stride,
+			      hb_position_t *first_advance,
+			      unsigned int advance_stride);
+void
+hb_font_get_glyph_v_advances (hb_font_t *font,
+			      unsigned int count,
+			      const hb_codepoint_t *first_glyph,
+			      unsigned int glyph_stride,
+			      hb_position_t *first_advance,
+			      unsigned int advance_stride);
+
 
 /* high-level funcs, with fallback */
 
@@ -501,6 +596,24 @@ hb_font_get_ppem (hb_font_t *font,
 		  unsigned int *x_ppem,
 		  unsigned int *y_ppem);
 
+/*
+ * Optional glyph / advance lookup cache
+ */
+
+void
+hb_font_set_cache_enabled (hb_font_t *font,
+			   hb_bool_t  enabled);
+
+hb_bool_t
+hb_font_get_cache_enabled (hb_font_t *font);
+
+void
+hb_font_get_cache_stats (hb_font_t    *font,
+			 unsigned int *glyph_hits,
+			 unsigned int *glyph_misses,
+			 unsigned int *advance_hits,
+			 unsigned int *advance_misses);
+
 
 HB_END_DECLS
 
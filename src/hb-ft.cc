@@ -130,6 +130,88 @@ hb_ft_get_glyph_v_advance (hb_font_t *font HB_UNUSED,
   return (-v + (1<<9)) >> 10;
 }
 
+static unsigned int
+hb_ft_get_glyphs (hb_font_t *font HB_UNUSED,
+		  void *font_data,
+		  unsigned int count,
+		  const hb_codepoint_t *first_unicode,
+		  unsigned int unicode_stride,
+		  hb_codepoint_t *first_glyph,
+		  unsigned int glyph_stride,
+		  void *user_data HB_UNUSED)
+{
+  FT_Face ft_face = (FT_Face) font_data;
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    unsigned int g = FT_Get_Char_Index (ft_face, *first_unicode);
+    if (unlikely (!g))
+      return i;
+    *first_glyph = g;
+
+    first_unicode = hb_font_stride_next (first_unicode, unicode_stride);
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+  }
+  return count;
+}
+
+static void
+hb_ft_get_glyph_h_advances (hb_font_t *font,
+			    void *font_data,
+			    unsigned int count,
+			    const hb_codepoint_t *first_glyph,
+			    unsigned int glyph_stride,
+			    hb_position_t *first_advance,
+			    unsigned int advance_stride,
+			    void *user_data HB_UNUSED)
+{
+  FT_Face ft_face = (FT_Face) font_data;
+  int load_flags = FT_LOAD_DEFAULT | FT_LOAD_NO_HINTING;
+  bool negate = font->x_scale < 0;
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    FT_Fixed v;
+    if (unlikely (FT_Get_Advance (ft_face, *first_glyph, load_flags, &v)))
+      v = 0;
+    if (negate)
+      v = -v;
+    *first_advance = (v + (1<<9)) >> 10;
+
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+    first_advance = hb_font_stride_next (first_advance, advance_stride);
+  }
+}
+
+static void
+hb_ft_get_glyph_v_advances (hb_font_t *font,
+			    void *font_data,
+			    unsigned int count,
+			    const hb_codepoint_t *first_glyph,
+			    unsigned int glyph_stride,
+			    hb_position_t *first_advance,
+			    unsigned int advance_stride,
+			    void *user_data HB_UNUSED)
+{
+  FT_Face ft_face = (FT_Face) font_data;
+  int load_flags = FT_LOAD_DEFAULT | FT_LOAD_NO_HINTING | FT_LOAD_VERTICAL_LAYOUT;
+  bool negate = font->y_scale < 0;
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    FT_Fixed v;
+    if (unlikely (FT_Get_Advance (ft_face, *first_glyph, load_flags, &v)))
+      v = 0;
+    if (negate)
+      v = -v;
+    /* See hb_ft_get_glyph_v_advance(). */
+    *first_advance = (-v + (1<<9)) >> 10;
+
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+    first_advance = hb_font_stride_next (first_advance, advance_stride);
+  }
+}
+
 static hb_bool_t
 hb_ft_get_glyph_h_origin (hb_font_t *font HB_UNUSED,
 			  void *font_data HB_UNUSED,
@@ -28,6 +28,7 @@
 #define HB_OT_CMAP_TABLE_HH
 
 #include "hb-open-type-private.hh"
+#include "hb-set-private.hh"
 
 
 namespace OT {
@@ -39,6 +40,9 @@ namespace OT {
 
 #define HB_OT_TAG_cmap HB_TAG('c','m','a','p')
 
+/* Codepoints collected by collect_ranges() are clamped to this. */
+#define HB_OT_CMAP_MAX_CODEPOINT 0x10FFFFu
+
 
 struct CmapSubtableFormat0
 {
@@ -51,6 +55,11 @@ struct CmapSubtableFormat0
     return true;
   }
 
+  inline void collect_ranges (hb_set_t *out) const
+  {
+    out->add_range (0, 255);
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -126,6 +135,15 @@ struct CmapSubtableFormat4
     return true;
   }
 
+  inline void collect_ranges (hb_set_t *out) const
+  {
+    unsigned int segCount = this->segCountX2 / 2;
+    const USHORT *endCount = this->values;
+    const USHORT *startCount = endCount + segCount + 1;
+    for (unsigned int i = 0; i < segCount; i++)
+      out->add_range (startCount[i], endCount[i]);
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -176,6 +194,7 @@ struct CmapSubtableLongGroup
 {
   friend struct CmapSubtableFormat12;
   friend struct CmapSubtableFormat13;
+  template <typename T> friend struct CmapSubtableLongSegmented;
 
   int cmp (hb_codepoint_t codepoint) const
   {
@@ -212,6 +231,14 @@ struct CmapSubtableTrimmed
     return true;
   }
 
+  inline void collect_ranges (hb_set_t *out) const
+  {
+    unsigned int count = glyphIdArray.len;
+    if (!count || startCharCode > HB_OT_CMAP_MAX_CODEPOINT)
+      return;
+    out->add_range (startCharCode, MIN (startCharCode + (count - 1), HB_OT_CMAP_MAX_CODEPOINT));
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -245,6 +272,18 @@ struct CmapSubtableLongSegmented
     return true;
   }
 
+  inline void collect_ranges (hb_set_t *out) const
+  {
+    unsigned int count = groups.len;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      hb_codepoint_t start = groups[i].startCharCode;
+      if (start > HB_OT_CMAP_MAX_CODEPOINT)
+	continue;
+      out->add_range (start, MIN ((hb_codepoint_t) groups[i].endCharCode, HB_OT_CMAP_MAX_CODEPOINT));
+    }
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -416,6 +455,22 @@ struct CmapSubtable
     }
   }
 
+  /* Adds to @out every codepoint that get_glyph() may map; a superset
+   * of the actual mapping. */
+  inline void collect_ranges (hb_set_t *out) const
+  {
+    switch (u.format) {
+    case  0: u.format0 .collect_ranges (out); return;
+    case  4: u.format4 .collect_ranges (out); return;
+    case  6: u.format6 .collect_ranges (out); return;
+    case 10: u.format10.collect_ranges (out); return;
+    case 12: u.format12.collect_ranges (out); return;
+    case 13: u.format13.collect_ranges (out); return;
+    case 14:
+    default: return;
+    }
+  }
+
   inline glyph_variant_t get_glyph_variant (hb_codepoint_t codepoint,
 					    hb_codepoint_t variation_selector,
 					    hb_codepoint_t *glyph) const
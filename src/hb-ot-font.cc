@@ -31,8 +31,12 @@
 #include "hb-font-private.hh"
 
 #include "hb-ot-cmap-table.hh"
+#include "hb-ot-glyf-table.hh"
+#include "hb-ot-head-table.hh"
 #include "hb-ot-hhea-table.hh"
 #include "hb-ot-hmtx-table.hh"
+#include "hb-ot-kern-table.hh"
+#include "hb-ot-post-table.hh"
 
 
 struct hb_ot_face_metrics_accelerator_t
@@ -57,7 +61,7 @@ struct hb_ot_face_metrics_accelerator_t
 
     this->blob = OT::Sanitizer<OT::_mtx>::sanitize (face->reference_table (_mtx_tag));
     if (unlikely (!this->num_advances ||
-		  2 * (this->num_advances + this->num_metrics) < hb_blob_get_length (this->blob)))
+		  2 * (this->num_advances + this->num_metrics) > hb_blob_get_length (this->blob)))
     {
       this->num_metrics = this->num_advances = 0;
       hb_blob_destroy (this->blob);
@@ -89,12 +93,627 @@ struct hb_ot_face_metrics_accelerator_t
 
     return this->table->longMetric[glyph].advance;
   }
+
+  inline int get_side_bearing (hb_codepoint_t glyph) const
+  {
+    if (unlikely (glyph >= this->num_metrics))
+      return 0;
+
+    if (glyph < this->num_advances)
+      return this->table->longMetric[glyph].lsb;
+
+    /* The leadingBearingX array starts right after the last long metric. */
+    return OT::StructAtOffset<OT::SHORT> (this->table,
+					  4 * this->num_advances +
+					  2 * (glyph - this->num_advances));
+  }
+};
+
+struct hb_ot_face_glyf_accelerator_t
+{
+  bool short_offset;
+  unsigned int num_glyphs;
+  const OT::loca *loca;
+  const OT::glyf *glyf;
+  hb_blob_t *loca_blob;
+  hb_blob_t *glyf_blob;
+  unsigned int glyf_len;
+
+  inline void init (hb_face_t *face)
+  {
+    hb_blob_t *head_blob = OT::Sanitizer<OT::head>::sanitize (face->reference_table (HB_OT_TAG_head));
+    const OT::head *head = OT::Sanitizer<OT::head>::lock_instance (head_blob);
+    if ((unsigned int) head->indexToLocFormat > 1 || head->glyphDataFormat != 0)
+    {
+      /* Unknown format.  Leave num_glyphs=0, that takes care of disabling us. */
+      hb_blob_destroy (head_blob);
+      return;
+    }
+    this->short_offset = 0 == head->indexToLocFormat;
+    hb_blob_destroy (head_blob);
+
+    this->loca_blob = OT::Sanitizer<OT::loca>::sanitize (face->reference_table (HB_OT_TAG_loca));
+    this->loca = OT::Sanitizer<OT::loca>::lock_instance (this->loca_blob);
+    this->num_glyphs = MAX (1u, hb_blob_get_length (this->loca_blob) / (this->short_offset ? 2 : 4)) - 1;
+
+    this->glyf_blob = OT::Sanitizer<OT::glyf>::sanitize (face->reference_table (HB_OT_TAG_glyf));
+    this->glyf = OT::Sanitizer<OT::glyf>::lock_instance (this->glyf_blob);
+    this->glyf_len = hb_blob_get_length (this->glyf_blob);
+  }
+
+  inline void fini (void)
+  {
+    hb_blob_destroy (this->loca_blob);
+    hb_blob_destroy (this->glyf_blob);
+  }
+
+  inline bool get_offsets (hb_codepoint_t  glyph,
+			   unsigned int   *start_offset,
+			   unsigned int   *end_offset) const
+  {
+    if (unlikely (glyph >= this->num_glyphs))
+      return false;
+
+    if (this->short_offset)
+    {
+      *start_offset = 2 * this->loca->u.shortsZ[glyph];
+      *end_offset   = 2 * this->loca->u.shortsZ[glyph + 1];
+    }
+    else
+    {
+      *start_offset = this->loca->u.longsZ[glyph];
+      *end_offset   = this->loca->u.longsZ[glyph + 1];
+    }
+
+    return likely (*start_offset <= *end_offset && *end_offset <= this->glyf_len);
+  }
+
+  inline bool get_extents (hb_codepoint_t glyph,
+			   hb_glyph_extents_t *extents) const
+  {
+    unsigned int start_offset, end_offset;
+    if (!get_offsets (glyph, &start_offset, &end_offset))
+      return false;
+
+    if (end_offset - start_offset < OT::glyf::GlyphHeader::static_size)
+      return true; /* Empty glyph; zero extents. */
+
+    const OT::glyf::GlyphHeader &glyph_header = OT::StructAtOffset<OT::glyf::GlyphHeader> (this->glyf, start_offset);
+
+    extents->x_bearing = MIN (glyph_header.xMin, glyph_header.xMax);
+    extents->y_bearing = MAX (glyph_header.yMin, glyph_header.yMax);
+    extents->width     = MAX (glyph_header.xMin, glyph_header.xMax) - extents->x_bearing;
+    extents->height    = MIN (glyph_header.yMin, glyph_header.yMax) - extents->y_bearing;
+
+    return true;
+  }
+
+  enum point_result_t {
+    POINT_ERROR,
+    POINT_FOUND,
+    POINT_NOT_FOUND	/* Fewer points; *num_points has the count. */
+  };
+
+  /* Unhinted outline point @point_index, in font units.  Composite
+   * glyphs number their points by concatenating their components'. */
+  inline point_result_t get_contour_point (hb_codepoint_t glyph,
+					   unsigned int point_index,
+					   int *x, int *y,
+					   unsigned int *num_points) const
+  {
+    unsigned int components_left = HB_OT_GLYF_MAX_COMPONENTS;
+    return get_contour_point (glyph, point_index, x, y, num_points, 0, &components_left);
+  }
+
+  private:
+
+  /* Composites can reference the same component many times at every
+   * nesting level; components_left bounds the total walked per query. */
+  inline point_result_t get_contour_point (hb_codepoint_t glyph,
+					   unsigned int point_index,
+					   int *x, int *y,
+					   unsigned int *num_points,
+					   unsigned int nesting_level,
+					   unsigned int *components_left) const
+  {
+    unsigned int start_offset, end_offset;
+    *num_points = 0;
+    if (unlikely (nesting_level > HB_OT_GLYF_MAX_NESTING_LEVEL ||
+		  !get_offsets (glyph, &start_offset, &end_offset)))
+      return POINT_ERROR;
+
+    if (end_offset - start_offset < OT::glyf::GlyphHeader::static_size)
+      return POINT_NOT_FOUND; /* Empty glyph. */
+
+    const uint8_t *p = (const uint8_t *) this->glyf + start_offset;
+    const uint8_t *end = (const uint8_t *) this->glyf + end_offset;
+    int num_contours = OT::StructAtOffset<OT::glyf::GlyphHeader> (p, 0).numberOfContours;
+    p += OT::glyf::GlyphHeader::static_size;
+
+    if (num_contours >= 0)
+      return get_simple_point (p, end, num_contours, point_index, x, y, num_points);
+    else
+      return get_composite_point (p, end, point_index, x, y, num_points, nesting_level, components_left);
+  }
+
+  static inline unsigned int get_ushort (const uint8_t *p) { return (p[0] << 8) | p[1]; }
+  static inline int get_short (const uint8_t *p) { return (int16_t) get_ushort (p); }
+
+  static inline point_result_t get_simple_point (const uint8_t *p, const uint8_t *end,
+						 unsigned int num_contours,
+						 unsigned int point_index,
+						 int *x, int *y,
+						 unsigned int *num_points)
+  {
+    if (!num_contours)
+      return POINT_NOT_FOUND;
+    if (unlikely (end - p < (int) (2 * num_contours + 2)))
+      return POINT_ERROR;
+
+    unsigned int count = get_ushort (p + 2 * (num_contours - 1)) + 1;
+    p += 2 * num_contours;
+    p += 2 + get_ushort (p); /* Skip instructions. */
+
+    if (point_index >= count)
+    {
+      *num_points = count;
+      return POINT_NOT_FOUND;
+    }
+
+    /* Walk the flags once to find where the coordinate arrays start. */
+    const uint8_t *flags = p;
+    unsigned int x_bytes = 0;
+    for (unsigned int i = 0; i < count;)
+    {
+      if (unlikely (p >= end))
+	return POINT_ERROR;
+      unsigned int flag = *p++;
+      unsigned int repeat = 1;
+      if (flag & OT::glyf::FLAG_REPEAT)
+      {
+	if (unlikely (p >= end))
+	  return POINT_ERROR;
+	repeat += *p++;
+      }
+      repeat = MIN (repeat, count - i);
+      if (flag & OT::glyf::FLAG_X_SHORT)
+	x_bytes += repeat;
+      else if (!(flag & OT::glyf::FLAG_X_SAME))
+	x_bytes += 2 * repeat;
+      i += repeat;
+    }
+    const uint8_t *xs = p;
+    const uint8_t *ys = p + x_bytes;
+
+    /* And again to sum up the deltas. */
+    int px = 0, py = 0;
+    p = flags;
+    for (unsigned int i = 0; i <= point_index;)
+    {
+      unsigned int flag = *p++;
+      unsigned int repeat = 1;
+      if (flag & OT::glyf::FLAG_REPEAT)
+	repeat += *p++;
+      for (; repeat && i <= point_index; repeat--, i++)
+      {
+	if (flag & OT::glyf::FLAG_X_SHORT)
+	{
+	  if (unlikely (xs >= end)) return POINT_ERROR;
+	  px += flag & OT::glyf::FLAG_X_SAME ? *xs : -*xs;
+	  xs++;
+	}
+	else if (!(flag & OT::glyf::FLAG_X_SAME))
+	{
+	  if (unlikely (end - xs < 2)) return POINT_ERROR;
+	  px += get_short (xs);
+	  xs += 2;
+	}
+	if (flag & OT::glyf::FLAG_Y_SHORT)
+	{
+	  if (unlikely (ys >= end)) return POINT_ERROR;
+	  py += flag & OT::glyf::FLAG_Y_SAME ? *ys : -*ys;
+	  ys++;
+	}
+	else if (!(flag & OT::glyf::FLAG_Y_SAME))
+	{
+	  if (unlikely (end - ys < 2)) return POINT_ERROR;
+	  py += get_short (ys);
+	  ys += 2;
+	}
+      }
+    }
+
+    *x = px;
+    *y = py;
+    return POINT_FOUND;
+  }
+
+  inline point_result_t get_composite_point (const uint8_t *p, const uint8_t *end,
+					     unsigned int point_index,
+					     int *x, int *y,
+					     unsigned int *num_points,
+					     unsigned int nesting_level,
+					     unsigned int *components_left) const
+  {
+    unsigned int total = 0;
+    unsigned int flags;
+    do
+    {
+      if (unlikely (end - p < 4 || !*components_left))
+	return POINT_ERROR;
+      (*components_left)--;
+      flags = get_ushort (p);
+      hb_codepoint_t component = get_ushort (p + 2);
+      p += 4;
+
+      int dx, dy;
+      if (flags & OT::glyf::ARG_1_AND_2_ARE_WORDS)
+      {
+	if (unlikely (end - p < 4)) return POINT_ERROR;
+	dx = get_short (p);
+	dy = get_short (p + 2);
+	p += 4;
+      }
+      else
+      {
+	if (unlikely (end - p < 2)) return POINT_ERROR;
+	dx = (int8_t) p[0];
+	dy = (int8_t) p[1];
+	p += 2;
+      }
+
+      /* 2.14 fixed-point transform. */
+      int a = 1 << 14, b = 0, c = 0, d = 1 << 14;
+      if (flags & OT::glyf::WE_HAVE_A_SCALE)
+      {
+	if (unlikely (end - p < 2)) return POINT_ERROR;
+	a = d = get_short (p);
+	p += 2;
+      }
+      else if (flags & OT::glyf::WE_HAVE_AN_X_AND_Y_SCALE)
+      {
+	if (unlikely (end - p < 4)) return POINT_ERROR;
+	a = get_short (p);
+	d = get_short (p + 2);
+	p += 4;
+      }
+      else if (flags & OT::glyf::WE_HAVE_A_TWO_BY_TWO)
+      {
+	if (unlikely (end - p < 8)) return POINT_ERROR;
+	a = get_short (p);
+	b = get_short (p + 2);
+	c = get_short (p + 4);
+	d = get_short (p + 6);
+	p += 8;
+      }
+
+      int cx, cy;
+      unsigned int component_points;
+      switch (get_contour_point (component, point_index - total, &cx, &cy,
+				 &component_points, nesting_level + 1, components_left))
+      {
+	case POINT_ERROR:
+	  return POINT_ERROR;
+
+	case POINT_FOUND:
+	  /* Point-matched component placement is not supported. */
+	  if (unlikely (!(flags & OT::glyf::ARGS_ARE_XY_VALUES)))
+	    return POINT_ERROR;
+	  if ((flags & OT::glyf::SCALED_COMPONENT_OFFSET) &&
+	      !(flags & OT::glyf::UNSCALED_COMPONENT_OFFSET))
+	  {
+	    int sx = transform (a, c, dx, dy);
+	    dy = transform (b, d, dx, dy);
+	    dx = sx;
+	  }
+	  *x = transform (a, c, cx, cy) + dx;
+	  *y = transform (b, d, cx, cy) + dy;
+	  return POINT_FOUND;
+
+	case POINT_NOT_FOUND:
+	  total += component_points;
+	  break;
+      }
+    }
+    while (flags & OT::glyf::MORE_COMPONENTS);
+
+    *num_points = total;
+    return POINT_NOT_FOUND;
+  }
+
+  /* Each product is rounded half away from zero, like FreeType does. */
+  static inline int mul_2dot14 (int m, int v)
+  {
+    int64_t p = (int64_t) m * v;
+    return (int) (p >= 0 ? (p + (1 << 13)) >> 14 : -((-p + (1 << 13)) >> 14));
+  }
+  static inline int transform (int m0, int m1, int x, int y)
+  {
+    return mul_2dot14 (m0, x) + mul_2dot14 (m1, y);
+  }
+};
+
+struct hb_ot_face_kern_accelerator_t
+{
+  const OT::kern *table;
+  hb_blob_t *blob;
+
+  inline void init (hb_face_t *face)
+  {
+    this->blob = OT::Sanitizer<OT::kern>::sanitize (face->reference_table (HB_OT_TAG_kern));
+    this->table = OT::Sanitizer<OT::kern>::lock_instance (this->blob);
+  }
+
+  inline void fini (void)
+  {
+    hb_blob_destroy (this->blob);
+  }
+
+  inline int get_h_kerning (hb_codepoint_t left, hb_codepoint_t right) const
+  {
+    return this->table->get_h_kerning (left, right);
+  }
+};
+
+/* Open-addressing hash from glyph name to glyph, with linear probing.
+ * Slots hold glyph+1, zero meaning empty.  Glyphs are inserted in
+ * order, so of several glyphs sharing a name the lowest one is found. */
+struct hb_ot_post_name_index_t
+{
+  unsigned int mask;
+  uint32_t slots[VAR];
+};
+
+struct hb_ot_face_post_accelerator_t
+{
+  unsigned int num_glyphs; /* Glyphs that have names. */
+  const OT::USHORT *glyph_name_index; /* NULL for version 1 tables. */
+  const uint8_t **pool; /* Version 2 names beyond the standard ones. */
+  unsigned int pool_len;
+  hb_ot_post_name_index_t *name_index; /* Built on first reverse lookup. */
+  hb_blob_t *blob;
+
+  inline void init (hb_face_t *face)
+  {
+    this->num_glyphs = 0;
+    this->glyph_name_index = NULL;
+    this->pool = NULL;
+    this->pool_len = 0;
+    this->name_index = NULL;
+    this->blob = OT::Sanitizer<OT::post>::sanitize (face->reference_table (HB_OT_TAG_post));
+    const OT::post *post = OT::Sanitizer<OT::post>::lock_instance (this->blob);
+
+    switch (post->version.to_int ())
+    {
+      case 0x00010000u:
+	this->num_glyphs = HB_OT_POST_NUM_MAC_GLYPH_NAMES;
+	break;
+
+      case 0x00020000u:
+      {
+	const OT::postV2Tail &v2 = post->get_v2 ();
+	const uint8_t *names = (const uint8_t *) v2.get_names ();
+	const uint8_t *end = (const uint8_t *) hb_blob_get_data (this->blob, NULL) +
+			     hb_blob_get_length (this->blob);
+
+	/* Index the Pascal strings; a truncated last one is dropped. */
+	unsigned int count = 0;
+	for (const uint8_t *p = names; p < end && p + 1 + *p <= end; p += 1 + *p)
+	  count++;
+	if (count)
+	{
+	  this->pool = (const uint8_t **) calloc (count, sizeof (this->pool[0]));
+	  if (unlikely (!this->pool))
+	    break;
+	  for (const uint8_t *p = names; this->pool_len < count; p += 1 + *p)
+	    this->pool[this->pool_len++] = p;
+	}
+
+	this->num_glyphs = v2.glyphNameIndex.len;
+	this->glyph_name_index = v2.glyphNameIndex.array;
+	break;
+      }
+
+      default:
+	/* Version 3 has no names; version 2.5 is deprecated. */
+	break;
+    }
+  }
+
+  inline void fini (void)
+  {
+    free (this->pool);
+    free (this->name_index);
+    hb_blob_destroy (this->blob);
+  }
+
+  inline bool get_glyph_name (hb_codepoint_t glyph,
+			      const char **name, unsigned int *len) const
+  {
+    if (unlikely (glyph >= this->num_glyphs))
+      return false;
+
+    unsigned int index = this->glyph_name_index ? (unsigned int) this->glyph_name_index[glyph] : glyph;
+    if (index < HB_OT_POST_NUM_MAC_GLYPH_NAMES)
+    {
+      *name = OT::_hb_ot_post_mac_glyph_names[index];
+      *len = strlen (*name);
+      return true;
+    }
+
+    index -= HB_OT_POST_NUM_MAC_GLYPH_NAMES;
+    if (unlikely (index >= this->pool_len))
+      return false;
+    *name = (const char *) this->pool[index] + 1;
+    *len = *this->pool[index];
+    return *len != 0;
+  }
+
+  inline bool get_glyph_from_name (const char *name, unsigned int len,
+				   hb_codepoint_t *glyph) const
+  {
+    const hb_ot_post_name_index_t *index = get_name_index ();
+    if (unlikely (!index))
+      return false;
+
+    for (unsigned int i = hash (name, len) & index->mask; index->slots[i]; i = (i + 1) & index->mask)
+    {
+      const char *s;
+      unsigned int l;
+      hb_codepoint_t g = index->slots[i] - 1;
+      if (get_glyph_name (g, &s, &l) && l == len && !memcmp (s, name, len))
+      {
+	*glyph = g;
+	return true;
+      }
+    }
+    return false;
+  }
+
+  private:
+
+  static inline unsigned int hash (const char *s, unsigned int len)
+  {
+    unsigned int h = 0;
+    for (unsigned int i = 0; i < len; i++)
+      h = (h << 5) - h + (unsigned char) s[i];
+    return h;
+  }
+
+  /* Returns NULL if out of memory. */
+  inline const hb_ot_post_name_index_t *get_name_index (void) const
+  {
+    hb_ot_post_name_index_t *index = (hb_ot_post_name_index_t *) hb_atomic_ptr_get (&this->name_index);
+    if (likely (index))
+      return index;
+
+    /* At most half full. */
+    unsigned int size = 2;
+    while (size < 2 * this->num_glyphs)
+      size <<= 1;
+
+    index = (hb_ot_post_name_index_t *) calloc (1, sizeof (*index) + (size - 1) * sizeof (index->slots[0]));
+    if (unlikely (!index))
+      return NULL;
+    index->mask = size - 1;
+
+    for (hb_codepoint_t g = 0; g < this->num_glyphs; g++)
+    {
+      const char *s;
+      unsigned int l;
+      if (!get_glyph_name (g, &s, &l))
+	continue;
+      unsigned int i = hash (s, l) & index->mask;
+      while (index->slots[i])
+	i = (i + 1) & index->mask;
+      index->slots[i] = g + 1;
+    }
+
+    if (!hb_atomic_ptr_cmpexch (const_cast<hb_ot_post_name_index_t **> (&this->name_index), NULL, index))
+    {
+      free (index);
+      index = (hb_ot_post_name_index_t *) hb_atomic_ptr_get (&this->name_index);
+    }
+    return index;
+  }
 };
 
+
+/* Flat two-level cmap: pages[u >> 8] selects a 256-entry block of
+ * glyphs[], which holds glyph+1 (zero meaning unmapped).  Block zero
+ * is all zeros and is shared by every unpopulated page.  Built once per
+ * face and kept as face user-data. */
+struct hb_ot_face_flat_cmap_t
+{
+  unsigned int size; /* Total bytes, including this header. */
+  unsigned int num_pages;
+  uint16_t *pages;
+  uint16_t *glyphs;
+
+  static inline hb_ot_face_flat_cmap_t *create (const OT::CmapSubtable *table,
+						unsigned int max_size)
+  {
+    hb_ot_face_flat_cmap_t *flat = NULL;
+    uint16_t *page_map = NULL;
+    unsigned int num_pages = 0, num_blocks = 1, size;
+    hb_codepoint_t first, last;
+    hb_set_t ranges;
+    ranges.init ();
+
+    table->collect_ranges (&ranges);
+    if (unlikely (ranges.in_error) || ranges.is_empty ())
+      goto done;
+
+    num_pages = (ranges.get_max () >> 8) + 1;
+    page_map = (uint16_t *) calloc (num_pages, sizeof (page_map[0]));
+    if (unlikely (!page_map))
+      goto done;
+
+    /* Assign a block to every page touched by a range. */
+    last = HB_SET_VALUE_INVALID;
+    while (ranges.next_range (&first, &last))
+      for (unsigned int page = first >> 8; page <= last >> 8; page++)
+	if (!page_map[page])
+	  page_map[page] = num_blocks++;
+
+    size = sizeof (*flat) +
+	   num_pages * sizeof (flat->pages[0]) +
+	   num_blocks * 256 * sizeof (flat->glyphs[0]);
+    if (size > max_size)
+      goto done;
+
+    flat = (hb_ot_face_flat_cmap_t *) calloc (1, size);
+    if (unlikely (!flat))
+      goto done;
+    flat->size = size;
+    flat->num_pages = num_pages;
+    flat->pages = (uint16_t *) (flat + 1);
+    flat->glyphs = flat->pages + num_pages;
+    memcpy (flat->pages, page_map, num_pages * sizeof (flat->pages[0]));
+
+    last = HB_SET_VALUE_INVALID;
+    while (ranges.next_range (&first, &last))
+      for (hb_codepoint_t u = first; u <= last; u++)
+      {
+	hb_codepoint_t glyph;
+	if (!table->get_glyph (u, &glyph))
+	  continue;
+	/* Glyph 0xFFFF and up cannot be stored; leave such fonts alone. */
+	if (unlikely (glyph >= 0xFFFFu))
+	{
+	  free (flat);
+	  flat = NULL;
+	  goto done;
+	}
+	flat->glyphs[(flat->pages[u >> 8] << 8) + (u & 0xFF)] = glyph + 1;
+      }
+
+  done:
+    free (page_map);
+    ranges.fini ();
+    return flat;
+  }
+
+  inline bool get_glyph (hb_codepoint_t unicode, hb_codepoint_t *glyph) const
+  {
+    unsigned int page = unicode >> 8;
+    if (page >= num_pages)
+      return false;
+    unsigned int v = glyphs[(pages[page] << 8) + (unicode & 0xFF)];
+    if (!v)
+      return false;
+    *glyph = v - 1;
+    return true;
+  }
+};
+
+static hb_user_data_key_t hb_ot_face_flat_cmap_key;
+
 struct hb_ot_face_cmap_accelerator_t
 {
   const OT::CmapSubtable *table;
   const OT::CmapSubtable *uvs_table;
+  const hb_ot_face_flat_cmap_t *flat; /* Owned by the face; may be NULL. */
   hb_blob_t *blob;
 
   inline void init (hb_face_t *face)
@@ -125,6 +744,35 @@ struct hb_ot_face_cmap_accelerator_t
 
     this->table = subtable;
     this->uvs_table = subtable_uvs;
+    this->flat = NULL;
+  }
+
+  inline void set_flat_budget (hb_face_t *face, unsigned int max_size)
+  {
+    this->flat = NULL;
+    if (!max_size)
+      return;
+
+    hb_ot_face_flat_cmap_t *flat = (hb_ot_face_flat_cmap_t *)
+				   hb_face_get_user_data (face, &hb_ot_face_flat_cmap_key);
+    if (!flat)
+    {
+      flat = hb_ot_face_flat_cmap_t::create (this->table, max_size);
+      if (!flat)
+	return;
+      if (!hb_face_set_user_data (face, &hb_ot_face_flat_cmap_key, flat, free, false))
+      {
+	/* Lost a race to another font, or the face is inert. */
+	free (flat);
+	flat = (hb_ot_face_flat_cmap_t *)
+	       hb_face_get_user_data (face, &hb_ot_face_flat_cmap_key);
+	if (!flat)
+	  return;
+      }
+    }
+
+    if (flat->size <= max_size)
+      this->flat = flat;
   }
 
   inline void fini (void)
@@ -148,16 +796,85 @@ struct hb_ot_face_cmap_accelerator_t
       }
     }
 
+    if (this->flat && likely (unicode <= HB_OT_CMAP_MAX_CODEPOINT))
+      return this->flat->get_glyph (unicode, glyph);
+
     return this->table->get_glyph (unicode, glyph);
   }
 };
 
 
+struct hb_ot_face_h_metrics_accelerator_t : hb_ot_face_metrics_accelerator_t
+{
+  inline void init (hb_face_t *face)
+  {
+    hb_ot_face_metrics_accelerator_t::init (face, HB_OT_TAG_hhea, HB_OT_TAG_hmtx, face->get_upem () >> 1);
+  }
+};
+
+struct hb_ot_face_v_metrics_accelerator_t : hb_ot_face_metrics_accelerator_t
+{
+  inline void init (hb_face_t *face)
+  {
+    hb_ot_face_metrics_accelerator_t::init (face, HB_OT_TAG_vhea, HB_OT_TAG_vmtx, face->get_upem ());
+  }
+};
+
+
+/* Creates the accelerator on first use.  Concurrent first uses may
+ * each build one; the loser of the race throws its copy away. */
+template <typename T>
+struct hb_lazy_loader_t
+{
+  inline void init (hb_face_t *face_)
+  {
+    face = face_;
+    instance = NULL;
+  }
+
+  inline void fini (void)
+  {
+    if (instance)
+    {
+      instance->fini ();
+      free (instance);
+    }
+  }
+
+  /* Returns NULL if out of memory. */
+  inline T *get (void) const
+  {
+  retry:
+    T *p = (T *) hb_atomic_ptr_get (&instance);
+    if (unlikely (!p))
+    {
+      p = (T *) calloc (1, sizeof (T));
+      if (unlikely (!p))
+	return NULL;
+      p->init (face);
+      if (unlikely (!hb_atomic_ptr_cmpexch (const_cast<T **> (&instance), NULL, p)))
+      {
+	p->fini ();
+	free (p);
+	goto retry;
+      }
+    }
+    return p;
+  }
+
+  private:
+  hb_face_t *face;
+  T *instance;
+};
+
 struct hb_ot_font_t
 {
-  hb_ot_face_cmap_accelerator_t cmap;
-  hb_ot_face_metrics_accelerator_t h_metrics;
-  hb_ot_face_metrics_accelerator_t v_metrics;
+  hb_lazy_loader_t<hb_ot_face_cmap_accelerator_t> cmap;
+  hb_lazy_loader_t<hb_ot_face_h_metrics_accelerator_t> h_metrics;
+  hb_lazy_loader_t<hb_ot_face_v_metrics_accelerator_t> v_metrics;
+  hb_lazy_loader_t<hb_ot_face_glyf_accelerator_t> glyf;
+  hb_lazy_loader_t<hb_ot_face_kern_accelerator_t> kern;
+  hb_lazy_loader_t<hb_ot_face_post_accelerator_t> post;
 };
 
 
@@ -170,11 +887,13 @@ _hb_ot_font_create (hb_font_t *font)
   if (unlikely (!ot_font))
     return NULL;
 
-  unsigned int upem = face->get_upem ();
-
+  /* No table is touched until the first lookup that needs it. */
   ot_font->cmap.init (face);
-  ot_font->h_metrics.init (face, HB_OT_TAG_hhea, HB_OT_TAG_hmtx, upem>>1);
-  ot_font->v_metrics.init (face, HB_OT_TAG_vhea, HB_OT_TAG_vmtx, upem); /* TODO Can we do this lazily? */
+  ot_font->h_metrics.init (face);
+  ot_font->v_metrics.init (face);
+  ot_font->glyf.init (face);
+  ot_font->kern.init (face);
+  ot_font->post.init (face);
 
   return ot_font;
 }
@@ -185,6 +904,9 @@ _hb_ot_font_destroy (hb_ot_font_t *ot_font)
   ot_font->cmap.fini ();
   ot_font->h_metrics.fini ();
   ot_font->v_metrics.fini ();
+  ot_font->glyf.fini ();
+  ot_font->kern.fini ();
+  ot_font->post.fini ();
 
   free (ot_font);
 }
@@ -200,7 +922,10 @@ hb_ot_get_glyph (hb_font_t *font HB_UNUSED,
 
 {
   const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
-  return ot_font->cmap.get_glyph (unicode, variation_selector, glyph);
+  const hb_ot_face_cmap_accelerator_t *cmap = ot_font->cmap.get ();
+  if (unlikely (!cmap))
+    return false;
+  return cmap->get_glyph (unicode, variation_selector, glyph);
 }
 
 static hb_position_t
@@ -210,7 +935,10 @@ hb_ot_get_glyph_h_advance (hb_font_t *font HB_UNUSED,
 			   void *user_data HB_UNUSED)
 {
   const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
-  return font->em_scale_x (ot_font->h_metrics.get_advance (glyph));
+  const hb_ot_face_metrics_accelerator_t *h_metrics = ot_font->h_metrics.get ();
+  if (unlikely (!h_metrics))
+    return 0;
+  return font->em_scale_x (h_metrics->get_advance (glyph));
 }
 
 static hb_position_t
@@ -220,7 +948,10 @@ hb_ot_get_glyph_v_advance (hb_font_t *font HB_UNUSED,
 			   void *user_data HB_UNUSED)
 {
   const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
-  return font->em_scale_y (-(int) ot_font->v_metrics.get_advance (glyph));
+  const hb_ot_face_metrics_accelerator_t *v_metrics = ot_font->v_metrics.get ();
+  if (unlikely (!v_metrics))
+    return 0;
+  return font->em_scale_y (-(int) v_metrics->get_advance (glyph));
 }
 
 static hb_bool_t
@@ -254,8 +985,11 @@ hb_ot_get_glyph_h_kerning (hb_font_t *font,
 			   hb_codepoint_t right_glyph,
 			   void *user_data HB_UNUSED)
 {
-  /* TODO */
-  return 0;
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_kern_accelerator_t *kern = ot_font->kern.get ();
+  if (unlikely (!kern))
+    return 0;
+  return font->em_scale_x (kern->get_h_kerning (left_glyph, right_glyph));
 }
 
 static hb_position_t
@@ -270,18 +1004,31 @@ hb_ot_get_glyph_v_kerning (hb_font_t *font HB_UNUSED,
 }
 
 static hb_bool_t
-hb_ot_get_glyph_extents (hb_font_t *font HB_UNUSED,
+hb_ot_get_glyph_extents (hb_font_t *font,
 			 void *font_data,
 			 hb_codepoint_t glyph,
 			 hb_glyph_extents_t *extents,
 			 void *user_data HB_UNUSED)
 {
-  /* TODO */
-  return false;
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_glyf_accelerator_t *glyf = ot_font->glyf.get ();
+  if (unlikely (!glyf || !glyf->get_extents (glyph, extents)))
+    return false;
+
+  /* See hb_ot_get_glyph_contour_point(). */
+  const hb_ot_face_metrics_accelerator_t *h_metrics = ot_font->h_metrics.get ();
+  if (likely (h_metrics && h_metrics->num_metrics) && extents->width)
+    extents->x_bearing = h_metrics->get_side_bearing (glyph);
+
+  extents->x_bearing = font->em_scale_x (extents->x_bearing);
+  extents->y_bearing = font->em_scale_y (extents->y_bearing);
+  extents->width     = font->em_scale_x (extents->width);
+  extents->height    = font->em_scale_y (extents->height);
+  return true;
 }
 
 static hb_bool_t
-hb_ot_get_glyph_contour_point (hb_font_t *font HB_UNUSED,
+hb_ot_get_glyph_contour_point (hb_font_t *font,
 			       void *font_data,
 			       hb_codepoint_t glyph,
 			       unsigned int point_index,
@@ -289,8 +1036,24 @@ hb_ot_get_glyph_contour_point (hb_font_t *font HB_UNUSED,
 			       hb_position_t *y,
 			       void *user_data HB_UNUSED)
 {
-  /* TODO */
-  return false;
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_glyf_accelerator_t *glyf = ot_font->glyf.get ();
+  int px, py;
+  unsigned int num_points;
+  if (unlikely (!glyf) ||
+      glyf->get_contour_point (glyph, point_index, &px, &py, &num_points) != hb_ot_face_glyf_accelerator_t::POINT_FOUND)
+    return false;
+
+  /* Like FreeType, shift the outline so that xMin sits at the hmtx
+   * left side-bearing; the two disagree in some fonts. */
+  const hb_ot_face_metrics_accelerator_t *h_metrics = ot_font->h_metrics.get ();
+  hb_glyph_extents_t bounds;
+  if (likely (h_metrics && h_metrics->num_metrics) && glyf->get_extents (glyph, &bounds))
+    px += h_metrics->get_side_bearing (glyph) - bounds.x_bearing;
+
+  *x = font->em_scale_x (px);
+  *y = font->em_scale_y (py);
+  return true;
 }
 
 static hb_bool_t
@@ -300,8 +1063,20 @@ hb_ot_get_glyph_name (hb_font_t *font HB_UNUSED,
 		      char *name, unsigned int size,
 		      void *user_data HB_UNUSED)
 {
-  /* TODO */
-  return false;
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_post_accelerator_t *post = ot_font->post.get ();
+  const char *s;
+  unsigned int len;
+  if (unlikely (!post || !post->get_glyph_name (glyph, &s, &len)))
+    return false;
+
+  if (size)
+  {
+    len = MIN (len, size - 1);
+    memcpy (name, s, len);
+    name[len] = '\0';
+  }
+  return true;
 }
 
 static hb_bool_t
@@ -311,10 +1086,84 @@ hb_ot_get_glyph_from_name (hb_font_t *font HB_UNUSED,
 			   hb_codepoint_t *glyph,
 			   void *user_data HB_UNUSED)
 {
-  /* TODO */
-  return false;
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_post_accelerator_t *post = ot_font->post.get ();
+  if (unlikely (!post))
+    return false;
+  if (len < 0)
+    len = strlen (name);
+  return post->get_glyph_from_name (name, len, glyph);
 }
 
+static unsigned int
+hb_ot_get_glyphs (hb_font_t *font HB_UNUSED,
+		  void *font_data,
+		  unsigned int count,
+		  const hb_codepoint_t *first_unicode,
+		  unsigned int unicode_stride,
+		  hb_codepoint_t *first_glyph,
+		  unsigned int glyph_stride,
+		  void *user_data HB_UNUSED)
+{
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_cmap_accelerator_t *cmap = ot_font->cmap.get ();
+  if (unlikely (!cmap))
+    return 0;
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!cmap->get_glyph (*first_unicode, 0, first_glyph))
+      return i;
+
+    first_unicode = hb_font_stride_next (first_unicode, unicode_stride);
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+  }
+  return count;
+}
+
+static void
+hb_ot_get_glyph_h_advances (hb_font_t *font,
+			    void *font_data,
+			    unsigned int count,
+			    const hb_codepoint_t *first_glyph,
+			    unsigned int glyph_stride,
+			    hb_position_t *first_advance,
+			    unsigned int advance_stride,
+			    void *user_data HB_UNUSED)
+{
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_metrics_accelerator_t *h_metrics = ot_font->h_metrics.get ();
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    *first_advance = likely (h_metrics) ? font->em_scale_x (h_metrics->get_advance (*first_glyph)) : 0;
+
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+    first_advance = hb_font_stride_next (first_advance, advance_stride);
+  }
+}
+
+static void
+hb_ot_get_glyph_v_advances (hb_font_t *font,
+			    void *font_data,
+			    unsigned int count,
+			    const hb_codepoint_t *first_glyph,
+			    unsigned int glyph_stride,
+			    hb_position_t *first_advance,
+			    unsigned int advance_stride,
+			    void *user_data HB_UNUSED)
+{
+  const hb_ot_font_t *ot_font = (const hb_ot_font_t *) font_data;
+  const hb_ot_face_metrics_accelerator_t *v_metrics = ot_font->v_metrics.get ();
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    *first_advance = likely (v_metrics) ? font->em_scale_y (-(int) v_metrics->get_advance (*first_glyph)) : 0;
+
+    first_glyph = hb_font_stride_next (first_glyph, glyph_stride);
+    first_advance = hb_font_stride_next (first_advance, advance_stride);
+  }
+}
 
 static hb_font_funcs_t *
 _hb_ot_get_font_funcs (void)
@@ -350,3 +1199,40 @@ hb_ot_font_set_funcs (hb_font_t *font)
 		     ot_font,
 		     (hb_destroy_func_t) _hb_ot_font_destroy);
 }
+
+/**
+ * hb_ot_font_set_cmap_budget:
+ * @font: a font using the OpenType font functions.
+ * @max_bytes: memory allowed for the flattened cmap, or 0 to disable it.
+ *
+ * Makes character-to-glyph lookups on @font use a flattened copy of the
+ * face's cmap: a two-level array indexed by codepoint that answers each
+ * lookup with two loads instead of a binary search.  The array covers
+ * the BMP and every populated supplementary page; it is built once per
+ * face and shared by all fonts on it.  If it would take more than
+ * @max_bytes, the regular cmap search is used instead.  Fonts covering
+ * the European scripts typically need around 32kb; large CJK fonts need
+ * one to two hundred kilobytes.
+ *
+ * Must be called after hb_ot_font_set_funcs() and before the font is
+ * shared between threads.
+ *
+ * Return value: whether the flattened cmap is in use.
+ *
+ * Since: 0.9.41
+ **/
+hb_bool_t
+hb_ot_font_set_cmap_budget (hb_font_t    *font,
+			    unsigned int  max_bytes)
+{
+  if (font->immutable || font->klass != _hb_ot_get_font_funcs ())
+    return false;
+
+  hb_ot_font_t *ot_font = (hb_ot_font_t *) font->user_data;
+  hb_ot_face_cmap_accelerator_t *cmap = ot_font->cmap.get ();
+  if (unlikely (!cmap))
+    return false;
+  cmap->set_flat_budget (font->face, max_bytes);
+
+  return cmap->flat != NULL;
+}
@@ -39,6 +39,10 @@ HB_BEGIN_DECLS
 void
 hb_ot_font_set_funcs (hb_font_t *font);
 
+hb_bool_t
+hb_ot_font_set_cmap_budget (hb_font_t    *font,
+			    unsigned int  max_bytes);
+
 
 HB_END_DECLS
 
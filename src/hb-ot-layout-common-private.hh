@@ -711,6 +711,40 @@ struct CoverageFormat1
       glyphs->add (glyphArray[i]);
   }
 
+  inline bool get_bounds (hb_codepoint_t *first, hb_codepoint_t *last) const
+  {
+    unsigned int count = glyphArray.len;
+    if (unlikely (!count)) return false;
+    *first = *last = glyphArray[0];
+    for (unsigned int i = 1; i < count; i++)
+    {
+      *first = MIN (*first, (hb_codepoint_t) glyphArray[i]);
+      *last = MAX (*last, (hb_codepoint_t) glyphArray[i]);
+    }
+    return true;
+  }
+
+  inline unsigned int get_span (hb_codepoint_t *first, hb_codepoint_t *last, unsigned int *num_glyphs) const
+  {
+    /* Binary search only has a unique answer if the array is strictly
+     * increasing; don't materialize anything else. */
+    unsigned int count = glyphArray.len;
+    if (unlikely (!count)) return 0;
+    for (unsigned int i = 1; i < count; i++)
+      if (unlikely (glyphArray[i - 1] >= glyphArray[i])) return 0;
+    *first = glyphArray[0];
+    *last = glyphArray[count - 1];
+    *num_glyphs = count;
+    return count;
+  }
+
+  inline void materialize (hb_codepoint_t first, uint16_t *values) const
+  {
+    unsigned int count = glyphArray.len;
+    for (unsigned int i = 0; i < count; i++)
+      values[glyphArray[i] - first] = i + 1;
+  }
+
   public:
   /* Older compilers need this to be public. */
   struct Iter {
@@ -809,6 +843,63 @@ struct CoverageFormat2
       rangeRecord[i].add_coverage (glyphs);
   }
 
+  inline bool get_bounds (hb_codepoint_t *first, hb_codepoint_t *last) const
+  {
+    /* Sanitize doesn't check that ranges are well-formed.  A range with
+     * end < start never matches a glyph, so leave it out of the bounds. */
+    bool found = false;
+    unsigned int count = rangeRecord.len;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const RangeRecord &range = rangeRecord[i];
+      if (unlikely (range.start > range.end)) continue;
+      if (!found)
+      {
+        *first = range.start;
+        *last = range.end;
+        found = true;
+        continue;
+      }
+      *first = MIN (*first, (hb_codepoint_t) range.start);
+      *last = MAX (*last, (hb_codepoint_t) range.end);
+    }
+    return found;
+  }
+
+  inline unsigned int get_span (hb_codepoint_t *first, hb_codepoint_t *last, unsigned int *num_glyphs) const
+  {
+    /* Ranges must be disjoint and in order, and indices must fit
+     * (plus one) in 16 bits. */
+    unsigned int count = rangeRecord.len;
+    if (unlikely (!count)) return 0;
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const RangeRecord &range = rangeRecord[i];
+      if (unlikely (range.start > range.end ||
+		    (i && rangeRecord[i - 1].end >= range.start) ||
+		    (unsigned int) range.value + (range.end - range.start) >= 0xFFFFu))
+	return 0;
+      total += range.end - range.start + 1;
+    }
+    *first = rangeRecord[0].start;
+    *last = rangeRecord[count - 1].end;
+    *num_glyphs = total;
+    return count;
+  }
+
+  inline void materialize (hb_codepoint_t first, uint16_t *values) const
+  {
+    unsigned int count = rangeRecord.len;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const RangeRecord &range = rangeRecord[i];
+      unsigned int value = range.value + 1;
+      for (hb_codepoint_t g = range.start; g <= range.end; g++)
+	values[g - first] = value++;
+    }
+  }
+
   public:
   /* Older compilers need this to be public. */
   struct Iter {
@@ -915,8 +1006,42 @@ struct Coverage
     }
   }
 
+  /* Sets the smallest range outside of which get_coverage() returns
+   * NOT_COVERED.  Returns false if nothing is covered. */
+  inline bool get_bounds (hb_codepoint_t *first, hb_codepoint_t *last) const
+  {
+    switch (u.format) {
+    case 1: return u.format1.get_bounds (first, last);
+    case 2: return u.format2.get_bounds (first, last);
+    default:return false;
+    }
+  }
+
+  /* Returns the number of records to binary-search, or zero if the
+   * table cannot be materialized.  On success, sets the covered range
+   * and the number of glyphs in it that are covered. */
+  inline unsigned int get_span (hb_codepoint_t *first, hb_codepoint_t *last, unsigned int *num_glyphs) const
+  {
+    switch (u.format) {
+    case 1: return u.format1.get_span (first, last, num_glyphs);
+    case 2: return u.format2.get_span (first, last, num_glyphs);
+    default:return 0;
+    }
+  }
+
+  /* Stores coverage index plus one for every covered glyph into
+   * values[glyph - first].  Only valid after get_span() succeeded. */
+  inline void materialize (hb_codepoint_t first, uint16_t *values) const
+  {
+    switch (u.format) {
+    case 1: u.format1.materialize (first, values); return;
+    case 2: u.format2.materialize (first, values); return;
+    default:return;
+    }
+  }
+
   struct Iter {
-    Iter (void) : format (0) {};
+    Iter (void) : format (0), u () {};
     inline void init (const Coverage &c_) {
       format = c_.u.format;
       switch (format) {
@@ -990,6 +1115,15 @@ struct ClassDefFormat1
     return 0;
   }
 
+  inline bool get_bounds (hb_codepoint_t *first, hb_codepoint_t *last) const
+  {
+    unsigned int count = classValue.len;
+    if (unlikely (!count)) return false;
+    *first = startGlyph;
+    *last = startGlyph + count - 1;
+    return true;
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -1085,6 +1219,59 @@ struct ClassDefFormat2
     return false;
   }
 
+  inline bool get_bounds (hb_codepoint_t *first, hb_codepoint_t *last) const
+  {
+    /* Sanitize doesn't check that ranges are well-formed.  A range with
+     * end < start never matches a glyph, so leave it out of the bounds. */
+    bool found = false;
+    unsigned int count = rangeRecord.len;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const RangeRecord &range = rangeRecord[i];
+      if (unlikely (range.start > range.end)) continue;
+      if (!found)
+      {
+        *first = range.start;
+        *last = range.end;
+        found = true;
+        continue;
+      }
+      *first = MIN (*first, (hb_codepoint_t) range.start);
+      *last = MAX (*last, (hb_codepoint_t) range.end);
+    }
+    return found;
+  }
+
+  inline unsigned int get_span (hb_codepoint_t *first, hb_codepoint_t *last, unsigned int *num_glyphs) const
+  {
+    unsigned int count = rangeRecord.len;
+    if (unlikely (!count)) return 0;
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const RangeRecord &range = rangeRecord[i];
+      if (unlikely (range.start > range.end ||
+		    (i && rangeRecord[i - 1].end >= range.start)))
+	return 0;
+      total += range.end - range.start + 1;
+    }
+    *first = rangeRecord[0].start;
+    *last = rangeRecord[count - 1].end;
+    *num_glyphs = total;
+    return count;
+  }
+
+  inline void materialize (hb_codepoint_t first, uint16_t *values) const
+  {
+    unsigned int count = rangeRecord.len;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const RangeRecord &range = rangeRecord[i];
+      for (hb_codepoint_t g = range.start; g <= range.end; g++)
+	values[g - first] = range.value;
+    }
+  }
+
   protected:
   USHORT	classFormat;	/* Format identifier--format = 2 */
   SortedArrayOf<RangeRecord>
@@ -1132,6 +1319,35 @@ struct ClassDef
     }
   }
 
+  /* Sets the smallest range outside of which get_class() returns zero.
+   * Returns false if all glyphs are in class zero. */
+  inline bool get_bounds (hb_codepoint_t *first, hb_codepoint_t *last) const
+  {
+    switch (u.format) {
+    case 1: return u.format1.get_bounds (first, last);
+    case 2: return u.format2.get_bounds (first, last);
+    default:return false;
+    }
+  }
+
+  /* As with Coverage; format 1 is already indexed directly. */
+  inline unsigned int get_span (hb_codepoint_t *first, hb_codepoint_t *last, unsigned int *num_glyphs) const
+  {
+    switch (u.format) {
+    case 2: return u.format2.get_span (first, last, num_glyphs);
+    default:return 0;
+    }
+  }
+
+  /* Stores the class of every glyph in range into values[glyph - first]. */
+  inline void materialize (hb_codepoint_t first, uint16_t *values) const
+  {
+    switch (u.format) {
+    case 2: u.format2.materialize (first, values); return;
+    default:return;
+    }
+  }
+
   protected:
   union {
   USHORT		format;		/* Format identifier */
@@ -458,7 +458,7 @@ struct SinglePosFormat1
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int index = (this+coverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     valueFormat.apply_value (c->font, c->direction, this,
@@ -507,7 +507,7 @@ struct SinglePosFormat2
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int index = (this+coverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     if (likely (index >= valueCount)) return TRACE_RETURN (false);
@@ -690,7 +690,7 @@ struct PairPosFormat1
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int index = (this+coverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     hb_apply_context_t::skipping_iterator_t &skippy_iter = c->iter_input;
@@ -734,6 +734,50 @@ struct PairPosFormat1
   DEFINE_SIZE_ARRAY (10, pairSet);
 };
 
+/* A PairPosFormat2 subtable that only adjusts the advance of the first
+ * glyph, compiled to native arrays: the classes of both glyphs indexed
+ * directly by glyph, and the class-by-class matrix of advances. */
+struct hb_kern_matrix_t
+{
+  static inline bool apply_to (const void *obj, hb_apply_context_t *c)
+  {
+    return ((const hb_kern_matrix_t *) obj)->apply (c);
+  }
+
+  inline bool apply (hb_apply_context_t *c) const
+  {
+    TRACE_APPLY (this);
+    hb_buffer_t *buffer = c->buffer;
+    unsigned int i1 = buffer->cur().codepoint - first1;
+    unsigned int klass1 = likely (i1 < len1) ? class1[i1] : 0;
+    if (likely (!klass1)) return TRACE_RETURN (false);
+
+    hb_apply_context_t::skipping_iterator_t &skippy_iter = c->iter_input;
+    skippy_iter.reset (buffer->idx, 1);
+    if (!skippy_iter.next ()) return TRACE_RETURN (false);
+
+    unsigned int i2 = buffer->info[skippy_iter.idx].codepoint - first2;
+    unsigned int klass2 = likely (i2 < len2) ? class2[i2] : 0;
+    if (unlikely (klass2 >= class2_count)) return TRACE_RETURN (false);
+
+    if (likely (HB_DIRECTION_IS_HORIZONTAL (c->direction)))
+      buffer->cur_pos().x_advance += c->font->em_scale_x (values[(klass1 - 1) * class2_count + klass2]);
+
+    buffer->idx = skippy_iter.idx;
+    return TRACE_RETURN (true);
+  }
+
+  hb_codepoint_t first1;
+  unsigned int len1;
+  const uint16_t *class1;	/* Class plus one of covered glyphs with a valid
+				 * class; zero otherwise. */
+  hb_codepoint_t first2;
+  unsigned int len2;
+  const uint16_t *class2;	/* Class; class2_count if out of range. */
+  unsigned int class2_count;
+  const int16_t *values;	/* Class1-major advance adjustments. */
+};
+
 struct PairPosFormat2
 {
   inline void collect_glyphs (hb_collect_glyphs_context_t *c) const
@@ -757,11 +801,83 @@ struct PairPosFormat2
     return this+coverage;
   }
 
+  inline void collect_tables (hb_collect_tables_context_t *c) const
+  {
+    c->add_coverage (this+coverage);
+    c->add_class_def (this+classDef1);
+    c->add_class_def (this+classDef2);
+  }
+
+  /* Returns NULL unless only the advance of the first glyph is adjusted.
+   * The caller frees the result. */
+  inline hb_kern_matrix_t *compile_kern_matrix (void) const
+  {
+    if (valueFormat1 != ValueFormat::xAdvance || valueFormat2 != 0)
+      return NULL;
+
+    const Coverage &cov = this+coverage;
+    const ClassDef &klass1 = this+classDef1;
+    const ClassDef &klass2 = this+classDef2;
+    unsigned int count1 = class1Count;
+    unsigned int count2 = class2Count;
+
+    hb_codepoint_t first1, last1, first2, last2;
+    if (!cov.get_bounds (&first1, &last1))
+      return NULL;
+    if (!klass2.get_bounds (&first2, &last2))
+      first2 = last2 = 0;
+    if (unlikely (last1 < first1 || last2 < first2))
+      return NULL;
+
+    /* Glyph ids and class counts are 16-bit, so none of this overflows
+     * in 64 bits. */
+    uint64_t len1 = (uint64_t) last1 - first1 + 1;
+    uint64_t len2 = (uint64_t) last2 - first2 + 1;
+    uint64_t matrix_len = (uint64_t) count1 * count2;
+
+    /* Don't let sparse class arrays cost much more than the matrix. */
+    if (len1 + len2 > 4 * matrix_len + 16384)
+      return NULL;
+
+    uint64_t size = sizeof (hb_kern_matrix_t) + (len1 + len2 + matrix_len) * sizeof (uint16_t);
+    if (unlikely (size > (unsigned int) -1))
+      return NULL;
+
+    hb_kern_matrix_t *kern = (hb_kern_matrix_t *) malloc ((size_t) size);
+    if (unlikely (!kern))
+      return NULL;
+    uint16_t *class1 = (uint16_t *) (kern + 1);
+    uint16_t *class2 = class1 + len1;
+    int16_t *matrix = (int16_t *) (class2 + len2);
+
+    for (unsigned int i = 0; i < len1; i++)
+    {
+      hb_codepoint_t g = first1 + i;
+      unsigned int k = cov.get_coverage (g) == NOT_COVERED ? count1 : klass1.get_class (g);
+      class1[i] = k < count1 ? k + 1 : 0;
+    }
+    for (unsigned int i = 0; i < len2; i++)
+      class2[i] = MIN (klass2.get_class (first2 + i), count2);
+    /* valueFormat1 is xAdvance alone, so each record is one SHORT. */
+    for (unsigned int i = 0; i < matrix_len; i++)
+      matrix[i] = *CastP<SHORT> (&values[i]);
+
+    kern->first1 = first1;
+    kern->len1 = len1;
+    kern->class1 = class1;
+    kern->first2 = first2;
+    kern->len2 = len2;
+    kern->class2 = class2;
+    kern->class2_count = count2;
+    kern->values = matrix;
+    return kern;
+  }
+
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int index = (this+coverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     hb_apply_context_t::skipping_iterator_t &skippy_iter = c->iter_input;
@@ -772,8 +888,8 @@ struct PairPosFormat2
     unsigned int len2 = valueFormat2.get_len ();
     unsigned int record_len = len1 + len2;
 
-    unsigned int klass1 = (this+classDef1).get_class (buffer->cur().codepoint);
-    unsigned int klass2 = (this+classDef2).get_class (buffer->info[skippy_iter.idx].codepoint);
+    unsigned int klass1 = c->get_class (this+classDef1, buffer->cur().codepoint);
+    unsigned int klass2 = c->get_class (this+classDef2, buffer->info[skippy_iter.idx].codepoint);
     if (unlikely (klass1 >= class1Count || klass2 >= class2Count)) return TRACE_RETURN (false);
 
     const Value *v = &values[record_len * (klass1 * class2Count + klass2)];
@@ -837,6 +953,25 @@ struct PairPosFormat2
   DEFINE_SIZE_ARRAY (16, values);
 };
 
+inline hb_collect_tables_context_t::return_t
+hb_collect_tables_context_t::dispatch (const PairPosFormat2 &obj)
+{
+  obj.collect_tables (this);
+  return HB_VOID;
+}
+
+inline hb_get_subtables_context_t::return_t
+hb_get_subtables_context_t::dispatch (const PairPosFormat2 &obj)
+{
+  hb_ot_layout_subtable_accelerator_t *entry = add (obj);
+  if (likely (entry) && (entry->compiled = obj.compile_kern_matrix ()))
+  {
+    entry->obj = entry->compiled;
+    entry->apply_func = hb_kern_matrix_t::apply_to;
+  }
+  return HB_VOID;
+}
+
 struct PairPos
 {
   template <typename context_t>
@@ -904,14 +1039,14 @@ struct CursivePosFormat1
     /* We don't handle mark glyphs here. */
     if (unlikely (_hb_glyph_info_is_mark (&buffer->cur()))) return TRACE_RETURN (false);
 
-    const EntryExitRecord &this_record = entryExitRecord[(this+coverage).get_coverage  (buffer->cur().codepoint)];
+    const EntryExitRecord &this_record = entryExitRecord[c->get_coverage (this+coverage, buffer->cur().codepoint)];
     if (!this_record.exitAnchor) return TRACE_RETURN (false);
 
     hb_apply_context_t::skipping_iterator_t &skippy_iter = c->iter_input;
     skippy_iter.reset (buffer->idx, 1);
     if (!skippy_iter.next ()) return TRACE_RETURN (false);
 
-    const EntryExitRecord &next_record = entryExitRecord[(this+coverage).get_coverage  (buffer->info[skippy_iter.idx].codepoint)];
+    const EntryExitRecord &next_record = entryExitRecord[c->get_coverage (this+coverage, buffer->info[skippy_iter.idx].codepoint)];
     if (!next_record.entryAnchor) return TRACE_RETURN (false);
 
     unsigned int i = buffer->idx;
@@ -1036,11 +1171,17 @@ struct MarkBasePosFormat1
     return this+markCoverage;
   }
 
+  inline void collect_tables (hb_collect_tables_context_t *c) const
+  {
+    c->add_coverage (this+markCoverage);
+    c->add_coverage (this+baseCoverage);
+  }
+
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int mark_index = (this+markCoverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int mark_index = c->get_coverage (this+markCoverage, buffer->cur().codepoint);
     if (likely (mark_index == NOT_COVERED)) return TRACE_RETURN (false);
 
     /* now we search backwards for a non-mark glyph */
@@ -1057,7 +1198,7 @@ struct MarkBasePosFormat1
     /* Checking that matched glyph is actually a base glyph by GDEF is too strong; disabled */
     if (!_hb_glyph_info_is_base_glyph (&buffer->info[skippy_iter.idx])) { /*return TRACE_RETURN (false);*/ }
 
-    unsigned int base_index = (this+baseCoverage).get_coverage  (buffer->info[skippy_iter.idx].codepoint);
+    unsigned int base_index = c->get_coverage (this+baseCoverage, buffer->info[skippy_iter.idx].codepoint);
     if (base_index == NOT_COVERED) return TRACE_RETURN (false);
 
     return TRACE_RETURN ((this+markArray).apply (c, mark_index, base_index, this+baseArray, classCount, skippy_iter.idx));
@@ -1089,6 +1230,13 @@ struct MarkBasePosFormat1
   DEFINE_SIZE_STATIC (12);
 };
 
+inline hb_collect_tables_context_t::return_t
+hb_collect_tables_context_t::dispatch (const MarkBasePosFormat1 &obj)
+{
+  obj.collect_tables (this);
+  return HB_VOID;
+}
+
 struct MarkBasePos
 {
   template <typename context_t>
@@ -1134,11 +1282,17 @@ struct MarkLigPosFormat1
     return this+markCoverage;
   }
 
+  inline void collect_tables (hb_collect_tables_context_t *c) const
+  {
+    c->add_coverage (this+markCoverage);
+    c->add_coverage (this+ligatureCoverage);
+  }
+
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int mark_index = (this+markCoverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int mark_index = c->get_coverage (this+markCoverage, buffer->cur().codepoint);
     if (likely (mark_index == NOT_COVERED)) return TRACE_RETURN (false);
 
     /* now we search backwards for a non-mark glyph */
@@ -1151,7 +1305,7 @@ struct MarkLigPosFormat1
     if (!_hb_glyph_info_is_ligature (&buffer->info[skippy_iter.idx])) { /*return TRACE_RETURN (false);*/ }
 
     unsigned int j = skippy_iter.idx;
-    unsigned int lig_index = (this+ligatureCoverage).get_coverage  (buffer->info[j].codepoint);
+    unsigned int lig_index = c->get_coverage (this+ligatureCoverage, buffer->info[j].codepoint);
     if (lig_index == NOT_COVERED) return TRACE_RETURN (false);
 
     const LigatureArray& lig_array = this+ligatureArray;
@@ -1204,6 +1358,13 @@ struct MarkLigPosFormat1
   DEFINE_SIZE_STATIC (12);
 };
 
+inline hb_collect_tables_context_t::return_t
+hb_collect_tables_context_t::dispatch (const MarkLigPosFormat1 &obj)
+{
+  obj.collect_tables (this);
+  return HB_VOID;
+}
+
 struct MarkLigPos
 {
   template <typename context_t>
@@ -1244,11 +1405,17 @@ struct MarkMarkPosFormat1
     return this+mark1Coverage;
   }
 
+  inline void collect_tables (hb_collect_tables_context_t *c) const
+  {
+    c->add_coverage (this+mark1Coverage);
+    c->add_coverage (this+mark2Coverage);
+  }
+
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
     hb_buffer_t *buffer = c->buffer;
-    unsigned int mark1_index = (this+mark1Coverage).get_coverage  (buffer->cur().codepoint);
+    unsigned int mark1_index = c->get_coverage (this+mark1Coverage, buffer->cur().codepoint);
     if (likely (mark1_index == NOT_COVERED)) return TRACE_RETURN (false);
 
     /* now we search backwards for a suitable mark glyph until a non-mark glyph */
@@ -1282,7 +1449,7 @@ struct MarkMarkPosFormat1
     return TRACE_RETURN (false);
 
     good:
-    unsigned int mark2_index = (this+mark2Coverage).get_coverage  (buffer->info[j].codepoint);
+    unsigned int mark2_index = c->get_coverage (this+mark2Coverage, buffer->info[j].codepoint);
     if (mark2_index == NOT_COVERED) return TRACE_RETURN (false);
 
     return TRACE_RETURN ((this+mark1Array).apply (c, mark1_index, mark2_index, this+mark2Array, classCount, j));
@@ -1317,6 +1484,13 @@ struct MarkMarkPosFormat1
   DEFINE_SIZE_STATIC (12);
 };
 
+inline hb_collect_tables_context_t::return_t
+hb_collect_tables_context_t::dispatch (const MarkMarkPosFormat1 &obj)
+{
+  obj.collect_tables (this);
+  return HB_VOID;
+}
+
 struct MarkMarkPos
 {
   template <typename context_t>
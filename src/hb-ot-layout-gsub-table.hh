@@ -74,7 +74,7 @@ struct SingleSubstFormat1
   {
     TRACE_APPLY (this);
     hb_codepoint_t glyph_id = c->buffer->cur().codepoint;
-    unsigned int index = (this+coverage).get_coverage (glyph_id);
+    unsigned int index = c->get_coverage (this+coverage, glyph_id);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     /* According to the Adobe Annotated OpenType Suite, result is always
@@ -151,7 +151,7 @@ struct SingleSubstFormat2
   {
     TRACE_APPLY (this);
     hb_codepoint_t glyph_id = c->buffer->cur().codepoint;
-    unsigned int index = (this+coverage).get_coverage (glyph_id);
+    unsigned int index = c->get_coverage (this+coverage, glyph_id);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     if (unlikely (index >= substitute.len)) return TRACE_RETURN (false);
@@ -354,7 +354,7 @@ struct MultipleSubstFormat1
   {
     TRACE_APPLY (this);
 
-    unsigned int index = (this+coverage).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     return TRACE_RETURN ((this+sequence[index]).apply (c));
@@ -481,7 +481,7 @@ struct AlternateSubstFormat1
     TRACE_APPLY (this);
     hb_codepoint_t glyph_id = c->buffer->cur().codepoint;
 
-    unsigned int index = (this+coverage).get_coverage (glyph_id);
+    unsigned int index = c->get_coverage (this+coverage, glyph_id);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const AlternateSet &alt_set = this+alternateSet[index];
@@ -598,6 +598,10 @@ struct Ligature
     c->output->add (ligGlyph);
   }
 
+  inline unsigned int get_component_count (void) const { return component.len; }
+  /* Component i, starting from 1 for the second component. */
+  inline hb_codepoint_t get_component (unsigned int i) const { return component[i]; }
+
   inline bool would_apply (hb_would_apply_context_t *c) const
   {
     TRACE_WOULD_APPLY (this);
@@ -682,6 +686,148 @@ struct Ligature
   DEFINE_SIZE_ARRAY (4, component);
 };
 
+/* The ligatures of the larger LigatureSets of a LigatureSubstFormat1
+ * subtable, as tries keyed by the components after the first.  Instead
+ * of running match_input() for each ligature in turn, find() walks the
+ * buffer once and returns the first ligature, in the order of the set,
+ * that match_input() would accept. */
+struct hb_ligature_trie_t
+{
+  static const unsigned int NOT_FOUND = (unsigned int) -1;
+  static const unsigned int MIN_LIGATURES = 4;
+
+  struct node_t
+  {
+    hb_codepoint_t glyph;	/* Component leading here from the parent. */
+    unsigned int first_child;	/* Children are sorted by glyph. */
+    unsigned int child_count;
+    unsigned int lig_index;	/* Ligature ending here, or NOT_FOUND. */
+    unsigned int min_index;	/* Lowest lig_index in this subtree. */
+  };
+
+  static inline bool apply_to (const void *obj, hb_apply_context_t *c)
+  {
+    return ((const hb_ligature_trie_t *) obj)->apply (c);
+  }
+
+  /* Defined after LigatureSubstFormat1. */
+  inline bool apply (hb_apply_context_t *c) const;
+
+  inline bool has_set (unsigned int set_index) const
+  {
+    return set_index < set_count && roots[set_index] != NOT_FOUND;
+  }
+
+  inline unsigned int find (hb_apply_context_t *c, unsigned int set_index) const
+  {
+    /* Match the way match_input() sets up c->iter_input. */
+    hb_apply_context_t::matcher_t matcher;
+    matcher.init (c);
+    matcher.set_syllable (c->buffer->cur().syllable ());
+
+    return find (c, matcher, &nodes[roots[set_index]], c->buffer->idx, NOT_FOUND);
+  }
+
+  private:
+  inline unsigned int find (hb_apply_context_t *c,
+			    const hb_apply_context_t::matcher_t &matcher,
+			    const node_t *node,
+			    unsigned int pos,
+			    unsigned int best) const
+  {
+    if (node->min_index >= best)
+      return best;
+    best = MIN (best, node->lig_index);
+    if (best == node->min_index)
+      return best;
+
+    /* Glyphs that skippy_iter.next() may skip depend on the component
+     * it looks for: it stops at those that match.  Ligatures that
+     * continue past such a glyph cannot have it as next component. */
+    const hb_glyph_info_t *info = c->buffer->info;
+    unsigned int count = c->buffer->len;
+    bool skipped_maybe = false;
+    for (unsigned int i = pos + 1; i < count; i++)
+    {
+      hb_apply_context_t::matcher_t::may_skip_t skip = matcher.may_skip (c, info[i]);
+      if (unlikely (skip == hb_apply_context_t::matcher_t::SKIP_YES))
+	continue;
+
+      if (matcher.may_match (info[i], NULL) == hb_apply_context_t::matcher_t::MATCH_MAYBE)
+      {
+	const node_t *child = find_child (node, info[i].codepoint);
+	if (child && unlikely (skipped_maybe) &&
+	    was_skipped (c, matcher, pos, i, info[i].codepoint))
+	  child = NULL;
+	if (child && may_ligate (c->buffer->cur(), info[i]))
+	{
+	  best = find (c, matcher, child, i, best);
+	  if (best == node->min_index)
+	    return best;
+	}
+      }
+
+      if (skip == hb_apply_context_t::matcher_t::SKIP_NO)
+	break;
+      skipped_maybe = true;
+    }
+    return best;
+  }
+
+  inline const node_t *find_child (const node_t *node, hb_codepoint_t g) const
+  {
+    const node_t *children = &nodes[node->first_child];
+    int min = 0, max = (int) node->child_count - 1;
+    while (min <= max)
+    {
+      int mid = (min + max) / 2;
+      if (g < children[mid].glyph)
+	max = mid - 1;
+      else if (g > children[mid].glyph)
+	min = mid + 1;
+      else
+	return &children[mid];
+    }
+    return NULL;
+  }
+
+  /* Whether a glyph matching g was already stopped at between start and end. */
+  static inline bool was_skipped (hb_apply_context_t *c,
+				  const hb_apply_context_t::matcher_t &matcher,
+				  unsigned int start,
+				  unsigned int end,
+				  hb_codepoint_t g)
+  {
+    const hb_glyph_info_t *info = c->buffer->info;
+    for (unsigned int i = start + 1; i < end; i++)
+      if (info[i].codepoint == g &&
+	  matcher.may_skip (c, info[i]) == hb_apply_context_t::matcher_t::SKIP_MAYBE &&
+	  matcher.may_match (info[i], NULL) == hb_apply_context_t::matcher_t::MATCH_MAYBE)
+	return true;
+    return false;
+  }
+
+  /* The ligature component checks of match_input(). */
+  static inline bool may_ligate (const hb_glyph_info_t &first,
+				 const hb_glyph_info_t &info)
+  {
+    unsigned int first_lig_id = _hb_glyph_info_get_lig_id (&first);
+    unsigned int first_lig_comp = _hb_glyph_info_get_lig_comp (&first);
+    unsigned int this_lig_id = _hb_glyph_info_get_lig_id (&info);
+    unsigned int this_lig_comp = _hb_glyph_info_get_lig_comp (&info);
+
+    if (first_lig_id && first_lig_comp)
+      return first_lig_id == this_lig_id && first_lig_comp == this_lig_comp;
+    return !(this_lig_id && this_lig_comp && this_lig_id != first_lig_id);
+  }
+
+  public:
+  const LigatureSubstFormat1 *subtable;
+  unsigned int set_count;
+  const unsigned int *roots;	/* Root node of each set, or NOT_FOUND. */
+  const node_t *nodes;
+};
+
 struct LigatureSet
 {
   inline void closure (hb_closure_context_t *c) const
@@ -726,6 +872,59 @@ struct LigatureSet
     return TRACE_RETURN (false);
   }
 
+  inline unsigned int get_ligature_count (void) const { return ligature.len; }
+  inline const Ligature &get_ligature (unsigned int i) const { return this+ligature[i]; }
+
+  /* Upper bound of the number of nodes of compile_trie(). */
+  inline unsigned int get_max_trie_nodes (void) const
+  {
+    unsigned int nodes = 1;
+    unsigned int num_ligs = ligature.len;
+    for (unsigned int i = 0; i < num_ligs; i++)
+    {
+      unsigned int count = (this+ligature[i]).get_component_count ();
+      if (count)
+	nodes += count - 1;
+    }
+    return nodes;
+  }
+
+  /* Builds the trie of the ligatures at nodes[*node_count], the root,
+   * and on.  Returns false if some ligature can't go in a trie. */
+  inline bool compile_trie (hb_ligature_trie_t::node_t *nodes,
+			    unsigned int *node_count) const
+  {
+    unsigned int num_ligs = ligature.len;
+    trie_entry_t *entries = (trie_entry_t *) calloc (MAX (num_ligs, 1u), sizeof (entries[0]));
+    if (unlikely (!entries))
+      return false;
+
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < num_ligs; i++)
+    {
+      const Ligature &lig = this+ligature[i];
+      unsigned int component_count = lig.get_component_count ();
+      if (!component_count)
+	continue; /* Never applies. */
+      if (unlikely (component_count > MAX_CONTEXT_LENGTH))
+      {
+	free (entries);
+	return false;
+      }
+      entries[count].lig = &lig;
+      entries[count].index = i;
+      count++;
+    }
+    ::qsort (entries, count, sizeof (entries[0]), (hb_compare_func_t) trie_entry_t::cmp);
+
+    unsigned int root = (*node_count)++;
+    nodes[root].glyph = 0;
+    build_trie (nodes, node_count, root, entries, count, 0);
+
+    free (entries);
+    return true;
+  }
+
   inline bool serialize (hb_serialize_context_t *c,
 			 Supplier<GlyphID> &ligatures,
 			 Supplier<unsigned int> &component_count_list,
@@ -751,6 +950,69 @@ struct LigatureSet
     return TRACE_RETURN (ligature.sanitize (c, this));
   }
 
+  private:
+  struct trie_entry_t
+  {
+    const Ligature *lig;
+    unsigned int index;
+
+    /* By components, prefixes first, then by index. */
+    static int cmp (const trie_entry_t *a, const trie_entry_t *b)
+    {
+      unsigned int a_count = a->lig->get_component_count ();
+      unsigned int b_count = b->lig->get_component_count ();
+      for (unsigned int i = 1; i < a_count && i < b_count; i++)
+      {
+	hb_codepoint_t a_glyph = a->lig->get_component (i);
+	hb_codepoint_t b_glyph = b->lig->get_component (i);
+	if (a_glyph != b_glyph)
+	  return a_glyph < b_glyph ? -1 : 1;
+      }
+      if (a_count != b_count)
+	return a_count < b_count ? -1 : 1;
+      return a->index < b->index ? -1 : a->index > b->index ? 1 : 0;
+    }
+  };
+
+  /* Fills in nodes[node] from the sorted entries, which all share
+   * their first depth components after the first. */
+  static inline void build_trie (hb_ligature_trie_t::node_t *nodes,
+				 unsigned int *node_count,
+				 unsigned int node,
+				 const trie_entry_t *entries,
+				 unsigned int count,
+				 unsigned int depth)
+  {
+    unsigned int i = 0;
+    nodes[node].lig_index = hb_ligature_trie_t::NOT_FOUND;
+    for (; i < count && entries[i].lig->get_component_count () == depth + 1; i++)
+      nodes[node].lig_index = MIN (nodes[node].lig_index, entries[i].index);
+    nodes[node].min_index = nodes[node].lig_index;
+
+    /* One child per distinct next component. */
+    unsigned int child_count = 0;
+    for (unsigned int j = i; j < count; j++)
+      if (j == i ||
+	  entries[j].lig->get_component (depth + 1) != entries[j - 1].lig->get_component (depth + 1))
+	child_count++;
+    unsigned int child = *node_count;
+    nodes[node].first_child = child;
+    nodes[node].child_count = child_count;
+    *node_count += child_count;
+
+    for (unsigned int j = i; j < count; child++)
+    {
+      hb_codepoint_t glyph = entries[j].lig->get_component (depth + 1);
+      unsigned int k = j + 1;
+      while (k < count && entries[k].lig->get_component (depth + 1) == glyph)
+	k++;
+      nodes[child].glyph = glyph;
+      build_trie (nodes, node_count, child, entries + j, k - j, depth + 1);
+      nodes[node].min_index = MIN (nodes[node].min_index, nodes[child].min_index);
+      j = k;
+    }
+  }
+
   protected:
   OffsetArrayOf<Ligature>
 		ligature;		/* Array LigatureSet tables
@@ -796,18 +1058,78 @@ struct LigatureSubstFormat1
     return TRACE_RETURN (lig_set.would_apply (c));
   }
 
-  inline bool apply (hb_apply_context_t *c) const
+  inline bool apply (hb_apply_context_t *c,
+		     const hb_ligature_trie_t *trie = NULL) const
   {
     TRACE_APPLY (this);
     hb_codepoint_t glyph_id = c->buffer->cur().codepoint;
 
-    unsigned int index = (this+coverage).get_coverage (glyph_id);
+    unsigned int index = c->get_coverage (this+coverage, glyph_id);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const LigatureSet &lig_set = this+ligatureSet[index];
+    if (trie && trie->has_set (index))
+    {
+      unsigned int i = trie->find (c, index);
+      return TRACE_RETURN (i != hb_ligature_trie_t::NOT_FOUND &&
+			   lig_set.get_ligature (i).apply (c));
+    }
     return TRACE_RETURN (lig_set.apply (c));
   }
 
+  /* Returns NULL if no LigatureSet is large enough to bother.
+   * The caller frees the result. */
+  inline hb_ligature_trie_t *compile_ligature_trie (void) const
+  {
+    unsigned int set_count = ligatureSet.len;
+    unsigned int max_nodes = 0;
+    for (unsigned int i = 0; i < set_count; i++)
+    {
+      const LigatureSet &lig_set = this+ligatureSet[i];
+      if (lig_set.get_ligature_count () >= hb_ligature_trie_t::MIN_LIGATURES)
+	max_nodes += lig_set.get_max_trie_nodes ();
+    }
+    if (!max_nodes)
+      return NULL;
+
+    hb_ligature_trie_t *trie = (hb_ligature_trie_t *) malloc (sizeof (hb_ligature_trie_t) +
+							      set_count * sizeof (unsigned int) +
+							      max_nodes * sizeof (hb_ligature_trie_t::node_t));
+    if (unlikely (!trie))
+      return NULL;
+    unsigned int *roots = (unsigned int *) (trie + 1);
+    hb_ligature_trie_t::node_t *nodes = (hb_ligature_trie_t::node_t *) (roots + set_count);
+
+    unsigned int node_count = 0;
+    bool compiled = false;
+    for (unsigned int i = 0; i < set_count; i++)
+    {
+      const LigatureSet &lig_set = this+ligatureSet[i];
+      roots[i] = hb_ligature_trie_t::NOT_FOUND;
+      if (lig_set.get_ligature_count () < hb_ligature_trie_t::MIN_LIGATURES)
+	continue;
+      unsigned int root = node_count;
+      if (lig_set.compile_trie (nodes, &node_count))
+      {
+	roots[i] = root;
+	compiled = true;
+      }
+      else
+	node_count = root;
+    }
+    if (!compiled)
+    {
+      free (trie);
+      return NULL;
+    }
+
+    trie->subtable = this;
+    trie->set_count = set_count;
+    trie->roots = roots;
+    trie->nodes = nodes;
+    return trie;
+  }
+
   inline bool serialize (hb_serialize_context_t *c,
 			 Supplier<GlyphID> &first_glyphs,
 			 Supplier<unsigned int> &ligature_per_first_glyph_count_list,
@@ -848,6 +1170,24 @@ struct LigatureSubstFormat1
   DEFINE_SIZE_ARRAY (6, ligatureSet);
 };
 
+inline bool
+hb_ligature_trie_t::apply (hb_apply_context_t *c) const
+{
+  return subtable->apply (c, this);
+}
+
+inline hb_get_subtables_context_t::return_t
+hb_get_subtables_context_t::dispatch (const LigatureSubstFormat1 &obj)
+{
+  hb_ot_layout_subtable_accelerator_t *entry = add (obj);
+  if (likely (entry) && (entry->compiled = obj.compile_ligature_trie ()))
+  {
+    entry->obj = entry->compiled;
+    entry->apply_func = hb_ligature_trie_t::apply_to;
+  }
+  return HB_VOID;
+}
+
 struct LigatureSubst
 {
   inline bool serialize (hb_serialize_context_t *c,
@@ -897,6 +1237,7 @@ struct ExtensionSubst : Extension<ExtensionSubst>
   typedef struct SubstLookupSubTable LookupSubTable;
 
   inline bool is_reverse (void) const;
+  inline bool matches_single_glyph (void) const;
 };
 
 
@@ -968,7 +1309,7 @@ struct ReverseChainSingleSubstFormat1
     if (unlikely (c->nesting_level_left != MAX_NESTING_LEVEL))
       return TRACE_RETURN (false); /* No chaining to this type */
 
-    unsigned int index = (this+coverage).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const OffsetArrayOf<Coverage> &lookahead = StructAfter<OffsetArrayOf<Coverage> > (backtrack);
@@ -1117,6 +1458,20 @@ struct SubstLookup : Lookup
     return lookup_type_is_reverse (type);
   }
 
+  /* Whether the lookup only looks at the glyph it substitutes. */
+  inline static bool lookup_type_matches_single_glyph (unsigned int lookup_type)
+  { return lookup_type == SubstLookupSubTable::Single ||
+	   lookup_type == SubstLookupSubTable::Multiple ||
+	   lookup_type == SubstLookupSubTable::Alternate; }
+
+  inline bool matches_single_glyph (void) const
+  {
+    unsigned int type = get_type ();
+    if (unlikely (type == SubstLookupSubTable::Extension))
+      return CastR<ExtensionSubst> (get_subtable(0)).matches_single_glyph ();
+    return lookup_type_matches_single_glyph (type);
+  }
+
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
@@ -1298,6 +1653,14 @@ GSUB::substitute_finish (hb_font_t *font HB_UNUSED, hb_buffer_t *buffer HB_UNUSE
   return SubstLookup::lookup_type_is_reverse (type);
 }
 
+/*static*/ inline bool ExtensionSubst::matches_single_glyph (void) const
+{
+  unsigned int type = get_type ();
+  if (unlikely (type == SubstLookupSubTable::Extension))
+    return CastR<ExtensionSubst> (get_subtable<LookupSubTable>()).matches_single_glyph ();
+  return SubstLookup::lookup_type_matches_single_glyph (type);
+}
+
 template <typename context_t>
 /*static*/ inline typename context_t::return_t SubstLookup::dispatch_recurse_func (context_t *c, unsigned int lookup_index)
 {
@@ -259,6 +259,143 @@ struct hb_add_coverage_context_t
 
 
 
+struct ContextFormat2;
+struct ChainContextFormat2;
+struct LigatureSubstFormat1;
+struct PairPosFormat2;
+struct MarkBasePosFormat1;
+struct MarkLigPosFormat1;
+struct MarkMarkPosFormat1;
+
+
+#ifndef HB_DEBUG_GET_SUBTABLES
+#define HB_DEBUG_GET_SUBTABLES (HB_DEBUG+0)
+#endif
+
+struct hb_get_subtables_context_t
+{
+  inline const char *get_name (void) { return "GET_SUBTABLES"; }
+  static const unsigned int max_debug_depth = HB_DEBUG_GET_SUBTABLES;
+  typedef hb_void_t return_t;
+  template <typename T, typename F>
+  inline bool may_dispatch (const T *obj, const F *format) { return true; }
+  template <typename T>
+  inline return_t dispatch (const T &obj)
+  {
+    add (obj);
+    return HB_VOID;
+  }
+  /* Subtables that may be compiled.  Defined after the subtable. */
+  inline return_t dispatch (const ChainContextFormat2 &obj);
+  inline return_t dispatch (const LigatureSubstFormat1 &obj);
+  inline return_t dispatch (const PairPosFormat2 &obj);
+  static return_t default_return_value (void) { return HB_VOID; }
+  bool stop_sublookup_iteration (return_t r HB_UNUSED) const { return false; }
+
+  hb_get_subtables_context_t (hb_ot_layout_subtable_accelerator_t *array_,
+			      unsigned int max_count_,
+			      unsigned int *count_) :
+			      array (array_),
+			      max_count (max_count_),
+			      count (count_),
+			      debug_depth (0) {}
+
+  hb_ot_layout_subtable_accelerator_t *array;
+  unsigned int max_count;
+  unsigned int *count;
+  unsigned int debug_depth;
+
+  private:
+  template <typename T>
+  inline hb_ot_layout_subtable_accelerator_t *add (const T &obj)
+  {
+    if (unlikely (*count >= max_count))
+      return NULL;
+    hb_ot_layout_subtable_accelerator_t *entry = &array[(*count)++];
+    entry->digest.init ();
+    obj.get_coverage ().add_coverage (&entry->digest);
+    entry->obj = &obj;
+    entry->apply_func = apply_to<T>;
+    return entry;
+  }
+
+  template <typename T>
+  static inline bool apply_to (const void *obj, hb_apply_context_t *c)
+  {
+    return ((const T *) obj)->apply (c);
+  }
+};
+
+
+
+#ifndef HB_DEBUG_COLLECT_TABLES
+#define HB_DEBUG_COLLECT_TABLES (HB_DEBUG+0)
+#endif
+
+/* Collects the Coverage and ClassDef tables looked up from apply(),
+ * as candidates for hb_ot_layout_table_cache_t. */
+struct hb_collect_tables_context_t
+{
+  struct table_t
+  {
+    const void *table;
+    bool is_class_def;
+
+    /* Coverage and ClassDef format 2 share a layout, so a font can use
+     * the same bytes as both; they materialize differently. */
+    static int cmp (const table_t *a, const table_t *b)
+    {
+      if (a->table != b->table)
+	return a->table < b->table ? -1 : 1;
+      return (int) a->is_class_def - (int) b->is_class_def;
+    }
+  };
+
+  inline const char *get_name (void) { return "COLLECT_TABLES"; }
+  static const unsigned int max_debug_depth = HB_DEBUG_COLLECT_TABLES;
+  typedef hb_void_t return_t;
+  template <typename T, typename F>
+  inline bool may_dispatch (const T *obj, const F *format) { return true; }
+  template <typename T>
+  inline return_t dispatch (const T &obj)
+  {
+    add_coverage (obj.get_coverage ());
+    return HB_VOID;
+  }
+  /* Subtables that look up more than their main coverage.  Defined
+   * after the subtables; they call their collect_tables(). */
+  inline return_t dispatch (const ContextFormat2 &obj);
+  inline return_t dispatch (const ChainContextFormat2 &obj);
+  inline return_t dispatch (const PairPosFormat2 &obj);
+  inline return_t dispatch (const MarkBasePosFormat1 &obj);
+  inline return_t dispatch (const MarkLigPosFormat1 &obj);
+  inline return_t dispatch (const MarkMarkPosFormat1 &obj);
+  static return_t default_return_value (void) { return HB_VOID; }
+  bool stop_sublookup_iteration (return_t r HB_UNUSED) const { return false; }
+
+  inline void add_coverage (const Coverage &coverage) { add (&coverage, false); }
+  inline void add_class_def (const ClassDef &class_def) { add (&class_def, true); }
+
+  hb_collect_tables_context_t (hb_prealloced_array_t<table_t> *tables_) :
+			       tables (tables_),
+			       debug_depth (0) {}
+
+  hb_prealloced_array_t<table_t> *tables;
+  unsigned int debug_depth;
+
+  private:
+  inline void add (const void *table, bool is_class_def)
+  {
+    table_t *t = tables->push ();
+    if (unlikely (!t))
+      return;
+    t->table = table;
+    t->is_class_def = is_class_def;
+  }
+};
+
+
+
 #ifndef HB_DEBUG_APPLY
 #define HB_DEBUG_APPLY (HB_DEBUG+0)
 #endif
@@ -285,6 +422,17 @@ struct hb_apply_context_t
 
     typedef bool (*match_func_t) (hb_codepoint_t glyph_id, const USHORT &value, const void *data);
 
+    inline void init (const hb_apply_context_t *c, bool context_match = false)
+    {
+      set_match_func (NULL, NULL);
+      set_lookup_props (c->lookup_props);
+      /* Ignore ZWNJ if we are matching GSUB context, or matching GPOS. */
+      set_ignore_zwnj (context_match || c->table_index == 1);
+      /* Ignore ZWJ if we are matching GSUB context, or matching GPOS, or if asked to. */
+      set_ignore_zwj (context_match || c->table_index == 1 || c->auto_zwj);
+      set_mask (context_match ? -1 : c->lookup_mask);
+    }
+
     inline void set_ignore_zwnj (bool ignore_zwnj_) { ignore_zwnj = ignore_zwnj_; }
     inline void set_ignore_zwj (bool ignore_zwj_) { ignore_zwj = ignore_zwj_; }
     inline void set_lookup_props (unsigned int lookup_props_) { lookup_props = lookup_props_; }
@@ -351,13 +499,7 @@ struct hb_apply_context_t
     {
       c = c_;
       match_glyph_data = NULL,
-      matcher.set_match_func (NULL, NULL);
-      matcher.set_lookup_props (c->lookup_props);
-      /* Ignore ZWNJ if we are matching GSUB context, or matching GPOS. */
-      matcher.set_ignore_zwnj (context_match || c->table_index == 1);
-      /* Ignore ZWJ if we are matching GSUB context, or matching GPOS, or if asked to. */
-      matcher.set_ignore_zwj (context_match || c->table_index == 1 || c->auto_zwj);
-      matcher.set_mask (context_match ? -1 : c->lookup_mask);
+      matcher.init (c, context_match);
     }
     inline void set_lookup_props (unsigned int lookup_props)
     {
@@ -481,6 +623,8 @@ struct hb_apply_context_t
   unsigned int lookup_props;
   const GDEF &gdef;
   bool has_glyph_classes;
+  const hb_ot_layout_table_cache_t *table_cache; /* NULL if empty. */
+  hb_set_digest_t *buffer_digest; /* Glyphs that may be in the buffer; NULL if not tracked. */
   skipping_iterator_t iter_input, iter_context;
   unsigned int debug_depth;
 
@@ -498,13 +642,42 @@ struct hb_apply_context_t
 			lookup_props (0),
 			gdef (*hb_ot_layout_from_face (face)->gdef),
 			has_glyph_classes (gdef.has_glyph_classes ()),
+			table_cache (hb_ot_layout_from_face (face)->table_cache.is_empty () ?
+				     NULL : &hb_ot_layout_from_face (face)->table_cache),
+			buffer_digest (NULL),
 			iter_input (),
 			iter_context (),
 			debug_depth (0) {}
 
+  /* Coverage and ClassDef lookups that go through the face's table
+   * cache, if the table was materialized. */
+  inline const hb_ot_layout_table_map_t *find_table_map (const Coverage &coverage) const
+  {
+    return table_cache ? table_cache->find (&coverage, false) : NULL;
+  }
+  inline const hb_ot_layout_table_map_t *find_table_map (const ClassDef &class_def) const
+  {
+    return table_cache ? table_cache->find (&class_def, true) : NULL;
+  }
+  inline unsigned int get_coverage (const Coverage &coverage, hb_codepoint_t glyph_id) const
+  {
+    const hb_ot_layout_table_map_t *map = find_table_map (coverage);
+    if (map)
+      return map->get_value (glyph_id) - 1; /* Zero wraps to NOT_COVERED. */
+    return coverage.get_coverage (glyph_id);
+  }
+  inline unsigned int get_class (const ClassDef &class_def, hb_codepoint_t glyph_id) const
+  {
+    const hb_ot_layout_table_map_t *map = find_table_map (class_def);
+    if (map)
+      return map->get_value (glyph_id);
+    return class_def.get_class (glyph_id);
+  }
+
   inline void set_lookup_mask (hb_mask_t mask) { lookup_mask = mask; }
   inline void set_auto_zwj (bool auto_zwj_) { auto_zwj = auto_zwj_; }
   inline void set_recurse_func (recurse_func_t func) { recurse_func = func; }
+  inline void set_buffer_digest (hb_set_digest_t *digest) { buffer_digest = digest; }
   inline void set_lookup (const Lookup &l) { set_lookup_props (l.get_props ()); }
   inline void set_lookup_props (unsigned int lookup_props_)
   {
@@ -558,6 +731,9 @@ struct hb_apply_context_t
 			  bool ligature = false,
 			  bool component = false) const
   {
+    if (buffer_digest)
+      buffer_digest->add (glyph_index);
+
     unsigned int add_in = _hb_glyph_info_get_glyph_props (&buffer->cur()) &
 			  HB_OT_LAYOUT_GLYPH_PROPS_PRESERVE;
     add_in |= HB_OT_LAYOUT_GLYPH_PROPS_SUBSTITUTED;
@@ -687,6 +863,11 @@ static inline bool match_class (hb_codepoint_t glyph_id, const USHORT &value, co
   const ClassDef &class_def = *reinterpret_cast<const ClassDef *>(data);
   return class_def.get_class (glyph_id) == value;
 }
+static inline bool match_class_map (hb_codepoint_t glyph_id, const USHORT &value, const void *data)
+{
+  const hb_ot_layout_table_map_t &map = *reinterpret_cast<const hb_ot_layout_table_map_t *>(data);
+  return map.get_value (glyph_id) == value;
+}
 static inline bool match_coverage (hb_codepoint_t glyph_id, const USHORT &value, const void *data)
 {
   const OffsetTo<Coverage> &coverage = (const OffsetTo<Coverage>&)value;
@@ -1288,7 +1469,7 @@ struct ContextFormat1
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
-    unsigned int index = (this+coverage).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED))
       return TRACE_RETURN (false);
 
@@ -1377,18 +1558,25 @@ struct ContextFormat2
     return this+coverage;
   }
 
+  inline void collect_tables (hb_collect_tables_context_t *c) const
+  {
+    c->add_coverage (this+coverage);
+    c->add_class_def (this+classDef);
+  }
+
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
-    unsigned int index = (this+coverage).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const ClassDef &class_def = this+classDef;
-    index = class_def.get_class (c->buffer->cur().codepoint);
+    const hb_ot_layout_table_map_t *class_map = c->find_table_map (class_def);
+    index = class_map ? class_map->get_value (c->buffer->cur().codepoint) : class_def.get_class (c->buffer->cur().codepoint);
     const RuleSet &rule_set = this+ruleSet[index];
     struct ContextApplyLookupContext lookup_context = {
-      {match_class},
-      &class_def
+      {class_map ? match_class_map : match_class},
+      class_map ? (const void *) class_map : &class_def
     };
     return TRACE_RETURN (rule_set.apply (c, lookup_context));
   }
@@ -1414,6 +1602,13 @@ struct ContextFormat2
   DEFINE_SIZE_ARRAY (8, ruleSet);
 };
 
+inline hb_collect_tables_context_t::return_t
+hb_collect_tables_context_t::dispatch (const ContextFormat2 &obj)
+{
+  obj.collect_tables (this);
+  return HB_VOID;
+}
+
 
 struct ContextFormat3
 {
@@ -1471,7 +1666,7 @@ struct ContextFormat3
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
-    unsigned int index = (this+coverageZ[0]).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverageZ[0], c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const LookupRecord *lookupRecord = &StructAtOffset<LookupRecord> (coverageZ, coverageZ[0].static_size * glyphCount);
@@ -1649,6 +1844,127 @@ static inline bool chain_context_apply_lookup (hb_apply_context_t *c,
 		       match_length);
 }
 
+struct ChainRuleSet;
+
+/* Index of the rules of the larger ChainRuleSets of a ChainContextFormat2
+ * subtable by the class of their second input glyph or, for rules with
+ * only one input glyph, of their first lookahead glyph.  The glyphs
+ * matched there are the first ones the skipping iterators stop at, so
+ * most rules can be rejected before running any of the matching. */
+struct hb_chain_rule_index_t
+{
+  static const unsigned int MIN_RULES = 8;
+
+  enum key_type_t {
+    KEY_INPUT,
+    KEY_LOOKAHEAD,
+    KEY_NONE
+  };
+
+  struct entry_t
+  {
+    uint16_t key;
+    uint16_t rule;
+
+    static int cmp (const entry_t *a, const entry_t *b)
+    {
+      if (a->key != b->key)
+	return a->key < b->key ? -1 : 1;
+      return a->rule < b->rule ? -1 : a->rule > b->rule ? 1 : 0;
+    }
+  };
+
+  /* The entries of a set are grouped by key type in the order of
+   * key_type_t, the first two groups sorted by key and rule. */
+  struct set_t
+  {
+    unsigned int start;
+    unsigned int count[3];
+    bool indexed;
+  };
+
+  static inline bool apply_to (const void *obj, hb_apply_context_t *c)
+  {
+    return ((const hb_chain_rule_index_t *) obj)->apply (c);
+  }
+
+  /* Defined after ChainContextFormat2. */
+  inline bool apply (hb_apply_context_t *c) const;
+
+  inline bool has_set (unsigned int set_index) const
+  {
+    return set_index < set_count && sets[set_index].indexed;
+  }
+
+  /* Applies the rules of the set that may match, in order, until one
+   * does.  Defined after ChainRuleSet. */
+  inline bool apply_set (hb_apply_context_t *c,
+			 unsigned int set_index,
+			 const ChainRuleSet &rule_set,
+			 ChainContextApplyLookupContext &lookup_context,
+			 const ClassDef &input_class_def,
+			 const ClassDef &lookahead_class_def) const;
+
+  private:
+  enum next_t {
+    NEXT_NONE,	/* No glyph can match. */
+    NEXT_GLYPH,	/* Only the returned glyph can match. */
+    NEXT_ANY	/* Depends on what is matched. */
+  };
+
+  /* The glyph after the current one that skippy_iter.next() stops at. */
+  static inline next_t next_glyph (hb_apply_context_t *c,
+				   const hb_apply_context_t::matcher_t &matcher,
+				   hb_codepoint_t *glyph)
+  {
+    const hb_glyph_info_t *info = c->buffer->info;
+    unsigned int count = c->buffer->len;
+    for (unsigned int i = c->buffer->idx + 1; i < count; i++)
+    {
+      hb_apply_context_t::matcher_t::may_skip_t skip = matcher.may_skip (c, info[i]);
+      if (unlikely (skip == hb_apply_context_t::matcher_t::SKIP_YES))
+	continue;
+      bool may_match = matcher.may_match (info[i], NULL) == hb_apply_context_t::matcher_t::MATCH_MAYBE;
+      if (skip == hb_apply_context_t::matcher_t::SKIP_MAYBE)
+      {
+	if (may_match)
+	  return NEXT_ANY;
+	continue;
+      }
+      if (!may_match)
+	return NEXT_NONE;
+      *glyph = info[i].codepoint;
+      return NEXT_GLYPH;
+    }
+    return NEXT_NONE;
+  }
+
+  /* Narrows [*start, *end) down to the entries with the key. */
+  static inline void find_key (const entry_t **start, const entry_t **end, unsigned int key)
+  {
+    const entry_t *lo = *start, *hi = *end;
+    while (lo < hi)
+    {
+      const entry_t *mid = lo + (hi - lo) / 2;
+      if (mid->key < key) lo = mid + 1; else hi = mid;
+    }
+    *start = lo;
+    hi = *end;
+    while (lo < hi)
+    {
+      const entry_t *mid = lo + (hi - lo) / 2;
+      if (mid->key <= key) lo = mid + 1; else hi = mid;
+    }
+    *end = lo;
+  }
+
+  public:
+  const ChainContextFormat2 *subtable;
+  unsigned int set_count;
+  const set_t *sets;
+  const entry_t *entries;
+};
+
 struct ChainRule
 {
   inline void closure (hb_closure_context_t *c, ChainContextClosureLookupContext &lookup_context) const
@@ -1692,6 +2008,23 @@ struct ChainRule
 							   lookup.array, lookup_context));
   }
 
+  inline hb_chain_rule_index_t::key_type_t get_index_key (unsigned int *key) const
+  {
+    const HeadlessArrayOf<USHORT> &input = StructAfter<HeadlessArrayOf<USHORT> > (backtrack);
+    if (input.len >= 2)
+    {
+      *key = input[1];
+      return hb_chain_rule_index_t::KEY_INPUT;
+    }
+    const ArrayOf<USHORT> &lookahead = StructAfter<ArrayOf<USHORT> > (input);
+    if (lookahead.len)
+    {
+      *key = lookahead[0];
+      return hb_chain_rule_index_t::KEY_LOOKAHEAD;
+    }
+    return hb_chain_rule_index_t::KEY_NONE;
+  }
+
   inline bool apply (hb_apply_context_t *c, ChainContextApplyLookupContext &lookup_context) const
   {
     TRACE_APPLY (this);
@@ -1775,6 +2108,34 @@ struct ChainRuleSet
     return TRACE_RETURN (false);
   }
 
+  inline unsigned int get_rule_count (void) const { return rule.len; }
+  inline const ChainRule &get_rule (unsigned int i) const { return this+rule[i]; }
+
+  /* Fills in the index entries of the rules, get_rule_count() of them. */
+  inline void compile_index (hb_chain_rule_index_t::set_t *set,
+			     hb_chain_rule_index_t::entry_t *entries) const
+  {
+    unsigned int num_rules = rule.len;
+    set->count[0] = set->count[1] = set->count[2] = 0;
+    for (unsigned int i = 0; i < num_rules; i++)
+    {
+      unsigned int key = 0;
+      set->count[(this+rule[i]).get_index_key (&key)]++;
+    }
+
+    unsigned int next[3] = {0, set->count[0], set->count[0] + set->count[1]};
+    for (unsigned int i = 0; i < num_rules; i++)
+    {
+      unsigned int key = 0;
+      hb_chain_rule_index_t::entry_t *entry = &entries[next[(this+rule[i]).get_index_key (&key)]++];
+      entry->key = key;
+      entry->rule = i;
+    }
+    ::qsort (entries, set->count[0], sizeof (entries[0]), (hb_compare_func_t) hb_chain_rule_index_t::entry_t::cmp);
+    ::qsort (entries + set->count[0], set->count[1], sizeof (entries[0]), (hb_compare_func_t) hb_chain_rule_index_t::entry_t::cmp);
+    set->indexed = true;
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -1789,6 +2150,61 @@ struct ChainRuleSet
   DEFINE_SIZE_ARRAY (2, rule);
 };
 
+inline bool
+hb_chain_rule_index_t::apply_set (hb_apply_context_t *c,
+				  unsigned int set_index,
+				  const ChainRuleSet &rule_set,
+				  ChainContextApplyLookupContext &lookup_context,
+				  const ClassDef &input_class_def,
+				  const ClassDef &lookahead_class_def) const
+{
+  const set_t &set = sets[set_index];
+  const entry_t *start[3], *end[3];
+  start[0] = entries + set.start;
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    end[i] = start[i] + set.count[i];
+    if (i < 2)
+      start[i + 1] = end[i];
+  }
+
+  /* Set up as match_input() and match_lookahead() do. */
+  hb_apply_context_t::matcher_t matcher;
+  matcher.set_syllable (c->buffer->cur().syllable ());
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    if (start[i] == end[i])
+      continue;
+    matcher.init (c, i == KEY_LOOKAHEAD);
+    hb_codepoint_t glyph = 0;
+    switch (next_glyph (c, matcher, &glyph))
+    {
+      case NEXT_NONE:
+	start[i] = end[i];
+	break;
+      case NEXT_GLYPH:
+	find_key (&start[i], &end[i],
+		  c->get_class (i == KEY_INPUT ? input_class_def : lookahead_class_def, glyph));
+	break;
+      case NEXT_ANY:
+	return rule_set.apply (c, lookup_context);
+    }
+  }
+
+  /* Try the remaining rules in the order of the set. */
+  for (;;)
+  {
+    unsigned int best = 3;
+    for (unsigned int i = 0; i < 3; i++)
+      if (start[i] < end[i] && (best == 3 || start[i]->rule < start[best]->rule))
+	best = i;
+    if (best == 3)
+      return false;
+    if (rule_set.get_rule (start[best]++->rule).apply (c, lookup_context))
+      return true;
+  }
+}
+
 struct ChainContextFormat1
 {
   inline void closure (hb_closure_context_t *c) const
@@ -1844,7 +2260,7 @@ struct ChainContextFormat1
   inline bool apply (hb_apply_context_t *c) const
   {
     TRACE_APPLY (this);
-    unsigned int index = (this+coverage).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const ChainRuleSet &rule_set = this+ruleSet[index];
@@ -1945,17 +2361,47 @@ struct ChainContextFormat2
     return this+coverage;
   }
 
-  inline bool apply (hb_apply_context_t *c) const
+  inline void collect_tables (hb_collect_tables_context_t *c) const
+  {
+    c->add_coverage (this+coverage);
+    c->add_class_def (this+backtrackClassDef);
+    c->add_class_def (this+inputClassDef);
+    c->add_class_def (this+lookaheadClassDef);
+  }
+
+  inline bool apply (hb_apply_context_t *c,
+		     const hb_chain_rule_index_t *rule_index = NULL) const
   {
     TRACE_APPLY (this);
-    unsigned int index = (this+coverage).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+coverage, c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const ClassDef &backtrack_class_def = this+backtrackClassDef;
     const ClassDef &input_class_def = this+inputClassDef;
     const ClassDef &lookahead_class_def = this+lookaheadClassDef;
 
-    index = input_class_def.get_class (c->buffer->cur().codepoint);
+    /* All three class definitions share one match function, so only
+     * use the materialized ones if all of them are. */
+    const hb_ot_layout_table_map_t *backtrack_class_map = c->find_table_map (backtrack_class_def);
+    const hb_ot_layout_table_map_t *input_class_map = c->find_table_map (input_class_def);
+    const hb_ot_layout_table_map_t *lookahead_class_map = c->find_table_map (lookahead_class_def);
+    if (backtrack_class_map && input_class_map && lookahead_class_map)
+    {
+      index = input_class_map->get_value (c->buffer->cur().codepoint);
+      const ChainRuleSet &rule_set = this+ruleSet[index];
+      struct ChainContextApplyLookupContext lookup_context = {
+	{match_class_map},
+	{backtrack_class_map,
+	 input_class_map,
+	 lookahead_class_map}
+      };
+      if (rule_index && rule_index->has_set (index))
+	return TRACE_RETURN (rule_index->apply_set (c, index, rule_set, lookup_context,
+						    input_class_def, lookahead_class_def));
+      return TRACE_RETURN (rule_set.apply (c, lookup_context));
+    }
+
+    index = c->get_class (input_class_def, c->buffer->cur().codepoint);
     const ChainRuleSet &rule_set = this+ruleSet[index];
     struct ChainContextApplyLookupContext lookup_context = {
       {match_class},
@@ -1963,9 +2409,54 @@ struct ChainContextFormat2
        &input_class_def,
        &lookahead_class_def}
     };
+    if (rule_index && rule_index->has_set (index))
+      return TRACE_RETURN (rule_index->apply_set (c, index, rule_set, lookup_context,
+						  input_class_def, lookahead_class_def));
     return TRACE_RETURN (rule_set.apply (c, lookup_context));
   }
 
+  /* Returns NULL if no ChainRuleSet is large enough to bother.
+   * The caller frees the result. */
+  inline hb_chain_rule_index_t *compile_rule_index (void) const
+  {
+    unsigned int set_count = ruleSet.len;
+    unsigned int entry_count = 0;
+    for (unsigned int i = 0; i < set_count; i++)
+    {
+      unsigned int num_rules = (this+ruleSet[i]).get_rule_count ();
+      if (num_rules >= hb_chain_rule_index_t::MIN_RULES)
+	entry_count += num_rules;
+    }
+    if (!entry_count)
+      return NULL;
+
+    hb_chain_rule_index_t *rule_index = (hb_chain_rule_index_t *) malloc (sizeof (hb_chain_rule_index_t) +
+									  set_count * sizeof (hb_chain_rule_index_t::set_t) +
+									  entry_count * sizeof (hb_chain_rule_index_t::entry_t));
+    if (unlikely (!rule_index))
+      return NULL;
+    hb_chain_rule_index_t::set_t *sets = (hb_chain_rule_index_t::set_t *) (rule_index + 1);
+    hb_chain_rule_index_t::entry_t *entries = (hb_chain_rule_index_t::entry_t *) (sets + set_count);
+
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < set_count; i++)
+    {
+      const ChainRuleSet &rule_set = this+ruleSet[i];
+      memset (&sets[i], 0, sizeof (sets[i]));
+      if (rule_set.get_rule_count () < hb_chain_rule_index_t::MIN_RULES)
+	continue;
+      sets[i].start = start;
+      rule_set.compile_index (&sets[i], entries + start);
+      start += rule_set.get_rule_count ();
+    }
+
+    rule_index->subtable = this;
+    rule_index->set_count = set_count;
+    rule_index->sets = sets;
+    rule_index->entries = entries;
+    return rule_index;
+  }
+
   inline bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
@@ -1998,6 +2489,31 @@ struct ChainContextFormat2
   DEFINE_SIZE_ARRAY (12, ruleSet);
 };
 
+inline hb_collect_tables_context_t::return_t
+hb_collect_tables_context_t::dispatch (const ChainContextFormat2 &obj)
+{
+  obj.collect_tables (this);
+  return HB_VOID;
+}
+
+inline bool
+hb_chain_rule_index_t::apply (hb_apply_context_t *c) const
+{
+  return subtable->apply (c, this);
+}
+
+inline hb_get_subtables_context_t::return_t
+hb_get_subtables_context_t::dispatch (const ChainContextFormat2 &obj)
+{
+  hb_ot_layout_subtable_accelerator_t *entry = add (obj);
+  if (likely (entry) && (entry->compiled = obj.compile_rule_index ()))
+  {
+    entry->obj = entry->compiled;
+    entry->apply_func = hb_chain_rule_index_t::apply_to;
+  }
+  return HB_VOID;
+}
+
 struct ChainContextFormat3
 {
   inline void closure (hb_closure_context_t *c) const
@@ -2072,7 +2588,7 @@ struct ChainContextFormat3
     TRACE_APPLY (this);
     const OffsetArrayOf<Coverage> &input = StructAfter<OffsetArrayOf<Coverage> > (backtrack);
 
-    unsigned int index = (this+input[0]).get_coverage (c->buffer->cur().codepoint);
+    unsigned int index = c->get_coverage (this+input[0], c->buffer->cur().codepoint);
     if (likely (index == NOT_COVERED)) return TRACE_RETURN (false);
 
     const OffsetArrayOf<Coverage> &lookahead = StructAfter<OffsetArrayOf<Coverage> > (input);
@@ -2290,4 +2806,37 @@ struct GSUBGPOS
 } /* namespace OT */
 
 
+template <typename TLookup>
+inline void
+hb_ot_layout_lookup_accelerator_t::init (const TLookup &lookup)
+{
+  digest.init ();
+  lookup.add_coverage (&digest);
+
+  /* Extension subtables dispatch to the subtable they wrap, so there
+   * is at most one entry per subtable. */
+  unsigned int count = lookup.get_subtable_count ();
+  subtable_count = 0;
+  has_compiled = false;
+  subtables = (hb_ot_layout_subtable_accelerator_t *) calloc (MAX (count, 1u), sizeof (subtables[0]));
+  if (unlikely (!subtables))
+    return;
+  OT::hb_get_subtables_context_t c (subtables, count, &subtable_count);
+  lookup.dispatch (&c);
+  for (unsigned int i = 0; i < subtable_count; i++)
+    if (subtables[i].compiled)
+      has_compiled = true;
+}
+
+inline bool
+hb_ot_layout_lookup_accelerator_t::apply (OT::hb_apply_context_t *c) const
+{
+  hb_codepoint_t g = c->buffer->cur().codepoint;
+  for (unsigned int i = 0; i < subtable_count; i++)
+    if (subtables[i].may_have (g) && subtables[i].apply (c))
+      return true;
+  return false;
+}
+
+
 #endif /* HB_OT_LAYOUT_GSUBGPOS_PRIVATE_HH */
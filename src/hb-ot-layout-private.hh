@@ -117,25 +117,118 @@ namespace OT {
   struct GPOS;
 }
 
+/* One non-extension subtable of a lookup, with the digest of its
+ * coverage and a direct pointer to its apply() method.  Some subtables
+ * are compiled into a native form, which obj then points to. */
+struct hb_ot_layout_subtable_accelerator_t
+{
+  typedef bool (*apply_func_t) (const void *obj, OT::hb_apply_context_t *c);
+
+  inline bool may_have (hb_codepoint_t g) const {
+    return digest.may_have (g);
+  }
+
+  inline bool apply (OT::hb_apply_context_t *c) const {
+    return apply_func (obj, c);
+  }
+
+  hb_set_digest_t digest;
+  const void *obj;
+  apply_func_t apply_func;
+  void *compiled; /* Owned; NULL if the subtable is applied directly. */
+};
+
 struct hb_ot_layout_lookup_accelerator_t
 {
+  /* Defined in hb-ot-layout-gsubgpos-private.hh. */
   template <typename TLookup>
-  inline void init (const TLookup &lookup)
-  {
-    digest.init ();
-    lookup.add_coverage (&digest);
-  }
+  inline void init (const TLookup &lookup);
 
   inline void fini (void)
   {
+    for (unsigned int i = 0; i < subtable_count; i++)
+      free (subtables[i].compiled);
+    free (subtables);
   }
 
   inline bool may_have (hb_codepoint_t g) const {
     return digest.may_have (g);
   }
+  /* False if the lookup can't apply to any of the glyphs in @glyphs. */
+  inline bool may_have (const hb_set_digest_t &glyphs) const {
+    return digest.may_have (glyphs);
+  }
+
+  /* Whether apply() is available; it's not if we ran out of memory. */
+  inline bool has_subtables (void) const {
+    return subtables != NULL;
+  }
+
+  /* Whether some subtable has a compiled form, which only apply() uses. */
+  inline bool has_compiled_subtables (void) const {
+    return has_compiled;
+  }
+
+  /* Applies the subtables, skipping those that cannot cover the
+   * current glyph.  Defined in hb-ot-layout-gsubgpos-private.hh. */
+  inline bool apply (OT::hb_apply_context_t *c) const;
 
   private:
   hb_set_digest_t digest;
+  unsigned int subtable_count;
+  hb_ot_layout_subtable_accelerator_t *subtables;
+  bool has_compiled;
+};
+
+/* A Coverage or ClassDef table copied into a native-endian array
+ * indexed by glyph.  For Coverage tables values[] holds the coverage
+ * index plus one, for ClassDef tables the class; zero means the glyph
+ * is not covered or is in class zero. */
+struct hb_ot_layout_table_map_t
+{
+  inline unsigned int get_value (hb_codepoint_t glyph_id) const
+  {
+    unsigned int i = glyph_id - first;
+    return likely (i < len) ? values[i] : 0;
+  }
+
+  const void *table;
+  bool is_class_def;
+  hb_codepoint_t first;
+  unsigned int len;
+  uint16_t values[1]; /* len items. */
+};
+
+/* Materialized tables of a face, keyed by table address and kind.
+ * Built once with the layout and read-only afterwards, within the
+ * budget set by hb_face_set_layout_table_cache_budget(). */
+struct hb_ot_layout_table_cache_t
+{
+  /* Defined in hb-ot-layout.cc. */
+  HB_INTERNAL void init (const struct OT::GSUB &gsub,
+			 const struct OT::GPOS &gpos,
+			 unsigned int budget);
+  HB_INTERNAL void fini (void);
+
+  inline bool is_empty (void) const { return !maps; }
+
+  inline const hb_ot_layout_table_map_t *find (const void *table, bool is_class_def) const
+  {
+    /* The table is at most half full, so there always is an empty slot. */
+    unsigned int i = hash (table, is_class_def) & mask;
+    for (const hb_ot_layout_table_map_t *map; (map = maps[i]); i = (i + 1) & mask)
+      if (map->table == table && map->is_class_def == is_class_def)
+	return map;
+    return NULL;
+  }
+
+  static inline unsigned int hash (const void *table, bool is_class_def)
+  {
+    return (unsigned int) (((uintptr_t) table >> 1) + is_class_def) * 2654435761u;
+  }
+
+  unsigned int mask;
+  hb_ot_layout_table_map_t **maps;
 };
 
 struct hb_ot_layout_t
@@ -153,6 +246,8 @@ struct hb_ot_layout_t
 
   hb_ot_layout_lookup_accelerator_t *gsub_accels;
   hb_ot_layout_lookup_accelerator_t *gpos_accels;
+
+  hb_ot_layout_table_cache_t table_cache;
 };
 
 
@@ -166,6 +261,38 @@ _hb_ot_layout_destroy (hb_ot_layout_t *layout);
 #define hb_ot_layout_from_face(face) ((hb_ot_layout_t *) face->shaper_data.ot)
 
 
+/*
+ * hb_ot_layout_closure_t
+ */
+
+/* Computes GSUB glyph closures over a set of lookups, revisiting only
+ * the lookups that the glyphs added in the previous round may affect. */
+struct hb_ot_layout_closure_t
+{
+  struct lookup_t
+  {
+    unsigned int index;
+    /* The closure of lookups that match a single glyph only depends on
+     * the glyphs in their coverage, which their accelerator's digest
+     * has.  We revisit the others after any change. */
+    const hb_ot_layout_lookup_accelerator_t *accel; /* NULL for the others. */
+  };
+
+  /* Defined in hb-ot-layout.cc. */
+  HB_INTERNAL void init (hb_face_t *face, const hb_set_t *lookup_indices);
+  HB_INTERNAL void fini (void);
+
+  /* Adds to glyphs what the lookups reach from them, given that glyphs
+   * is already closed but for added, which it also contains.  If
+   * new_glyphs is not NULL, the glyphs this adds are added to it too. */
+  HB_INTERNAL void closure (hb_set_t *glyphs, const hb_set_t *added,
+			    hb_set_t *new_glyphs = NULL) const;
+
+  hb_face_t *face;
+  hb_prealloced_array_t<lookup_t> lookups;
+};
+
+
 /*
  * Buffer var routines.
  */
@@ -199,6 +326,18 @@ _hb_glyph_info_set_unicode_props (hb_glyph_info_t *info, hb_unicode_funcs_t *uni
   info->unicode_props1() = unicode->modified_combining_class (info->codepoint);
 }
 
+/* Same as above, from properties looked up in bulk. */
+static inline void
+_hb_glyph_info_set_unicode_props (hb_glyph_info_t *info, hb_unicode_funcs_t *unicode,
+				  const hb_unicode_props_t &props)
+{
+  info->unicode_props0() = ((unsigned int) props.general_category) |
+			   (unicode->is_default_ignorable (info->codepoint) ? MASK0_IGNORABLE : 0) |
+			   (info->codepoint == 0x200Cu ? MASK0_ZWNJ : 0) |
+			   (info->codepoint == 0x200Du ? MASK0_ZWJ : 0);
+  info->unicode_props1() = unicode->modified_combining_class (info->codepoint, props.combining_class);
+}
+
 static inline void
 _hb_glyph_info_set_general_category (hb_glyph_info_t *info,
 				     hb_unicode_general_category_t gen_cat)
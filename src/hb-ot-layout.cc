@@ -77,6 +77,8 @@ _hb_ot_layout_create (hb_face_t *face)
   for (unsigned int i = 0; i < layout->gpos_lookup_count; i++)
     layout->gpos_accels[i].init (layout->gpos->get_lookup (i));
 
+  layout->table_cache.init (*layout->gsub, *layout->gpos, face->layout_table_cache_budget);
+
   return layout;
 }
 
@@ -91,6 +93,8 @@ _hb_ot_layout_destroy (hb_ot_layout_t *layout)
   free (layout->gsub_accels);
   free (layout->gpos_accels);
 
+  layout->table_cache.fini ();
+
   hb_blob_destroy (layout->gdef_blob);
   hb_blob_destroy (layout->gsub_blob);
   hb_blob_destroy (layout->gpos_blob);
@@ -98,6 +102,147 @@ _hb_ot_layout_destroy (hb_ot_layout_t *layout)
   free (layout);
 }
 
+
+/*
+ * hb_ot_layout_table_cache_t
+ */
+
+/* Tables with fewer records than this are binary-searched in a few
+ * steps already.  Tables whose span is more than this many times the
+ * number of glyphs they cover would mostly materialize zeros. */
+#define HB_OT_LAYOUT_TABLE_CACHE_MIN_RECORDS	8
+#define HB_OT_LAYOUT_TABLE_CACHE_MAX_SPARSENESS	16
+
+struct hb_ot_layout_table_candidate_t
+{
+  const void *table;
+  bool is_class_def;
+  unsigned int records;
+  hb_codepoint_t first;
+  unsigned int len;
+
+  /* Largest first. */
+  static int cmp (const hb_ot_layout_table_candidate_t *a,
+		  const hb_ot_layout_table_candidate_t *b)
+  {
+    return a->records > b->records ? -1 : a->records < b->records ? 1 :
+	   a->len < b->len ? -1 : a->len > b->len ? 1 : 0;
+  }
+};
+
+void
+hb_ot_layout_table_cache_t::init (const OT::GSUB &gsub,
+				  const OT::GPOS &gpos,
+				  unsigned int budget)
+{
+  mask = 0;
+  maps = NULL;
+  if (!budget)
+    return;
+
+  typedef OT::hb_collect_tables_context_t::table_t table_t;
+  hb_auto_array_t<table_t> tables;
+  OT::hb_collect_tables_context_t c (&tables);
+  unsigned int count = gsub.get_lookup_count ();
+  for (unsigned int i = 0; i < count; i++)
+    gsub.get_lookup (i).dispatch (&c);
+  count = gpos.get_lookup_count ();
+  for (unsigned int i = 0; i < count; i++)
+    gpos.get_lookup (i).dispatch (&c);
+  if (!tables.len)
+    return;
+
+  /* Tables are often shared between subtables; drop duplicates and
+   * those not worth materializing. */
+  tables.qsort ();
+  hb_auto_array_t<hb_ot_layout_table_candidate_t> candidates;
+  for (unsigned int i = 0; i < tables.len; i++)
+  {
+    if (i && tables[i].table == tables[i - 1].table &&
+	tables[i].is_class_def == tables[i - 1].is_class_def)
+      continue;
+
+    hb_codepoint_t first, last;
+    unsigned int num_glyphs;
+    unsigned int records = tables[i].is_class_def ?
+			   ((const OT::ClassDef *) tables[i].table)->get_span (&first, &last, &num_glyphs) :
+			   ((const OT::Coverage *) tables[i].table)->get_span (&first, &last, &num_glyphs);
+    if (records < HB_OT_LAYOUT_TABLE_CACHE_MIN_RECORDS)
+      continue;
+    unsigned int len = last - first + 1;
+    if (len / HB_OT_LAYOUT_TABLE_CACHE_MAX_SPARSENESS > num_glyphs)
+      continue;
+
+    hb_ot_layout_table_candidate_t *candidate = candidates.push ();
+    if (unlikely (!candidate))
+      break;
+    candidate->table = tables[i].table;
+    candidate->is_class_def = tables[i].is_class_def;
+    candidate->records = records;
+    candidate->first = first;
+    candidate->len = len;
+  }
+
+  /* Materialize the tables with the most records first, as long as they
+   * fit.  Each table also pays for two hash slots. */
+  candidates.qsort ();
+  unsigned int used = 0;
+  unsigned int selected = 0;
+  for (unsigned int i = 0; i < candidates.len; i++)
+  {
+    unsigned int size = sizeof (hb_ot_layout_table_map_t) +
+			candidates[i].len * sizeof (uint16_t) +
+			2 * sizeof (maps[0]);
+    if (size > budget - used)
+      continue;
+    used += size;
+    candidates[selected++] = candidates[i];
+  }
+  if (!selected)
+    return;
+
+  unsigned int size = 1;
+  while (size < 2 * selected)
+    size <<= 1;
+  maps = (hb_ot_layout_table_map_t **) calloc (size, sizeof (maps[0]));
+  if (unlikely (!maps))
+    return;
+  mask = size - 1;
+
+  for (unsigned int i = 0; i < selected; i++)
+  {
+    const hb_ot_layout_table_candidate_t &candidate = candidates[i];
+    hb_ot_layout_table_map_t *map = (hb_ot_layout_table_map_t *) calloc (1, sizeof (hb_ot_layout_table_map_t) +
+										candidate.len * sizeof (uint16_t));
+    if (unlikely (!map))
+      continue;
+    map->table = candidate.table;
+    map->is_class_def = candidate.is_class_def;
+    map->first = candidate.first;
+    map->len = candidate.len;
+    if (candidate.is_class_def)
+      ((const OT::ClassDef *) candidate.table)->materialize (map->first, map->values);
+    else
+      ((const OT::Coverage *) candidate.table)->materialize (map->first, map->values);
+
+    unsigned int j = hash (map->table, map->is_class_def) & mask;
+    while (maps[j])
+      j = (j + 1) & mask;
+    maps[j] = map;
+  }
+}
+
+void
+hb_ot_layout_table_cache_t::fini (void)
+{
+  if (!maps)
+    return;
+  for (unsigned int i = 0; i <= mask; i++)
+    free (maps[i]);
+  free (maps);
+}
+
+
 static inline const OT::GDEF&
 _get_gdef (hb_face_t *face)
 {
@@ -753,6 +898,100 @@ hb_ot_layout_lookup_substitute_closure (hb_face_t    *face,
   l.closure (&c);
 }
 
+/**
+ * hb_ot_layout_lookups_substitute_closure:
+ * @face: a face.
+ * @lookups: indices of the GSUB lookups to apply.
+ * @glyphs: (inout): glyphs to close over.
+ *
+ * Adds to @glyphs all the glyphs that the lookups may substitute them
+ * with, repeatedly, until there are no more.  This is the same as
+ * calling hb_ot_layout_lookup_substitute_closure() for each lookup
+ * until @glyphs stops changing, but only revisits the lookups that
+ * the newly added glyphs may affect.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_ot_layout_lookups_substitute_closure (hb_face_t      *face,
+					 const hb_set_t *lookups,
+					 hb_set_t       *glyphs)
+{
+  hb_ot_layout_closure_t closure;
+  closure.init (face, lookups);
+  closure.closure (glyphs, glyphs);
+  closure.fini ();
+}
+
+void
+hb_ot_layout_closure_t::init (hb_face_t *face_, const hb_set_t *lookup_indices)
+{
+  face = face_;
+  lookups.init ();
+
+  const OT::GSUB &gsub = _get_gsub (face);
+  unsigned int lookup_count = gsub.get_lookup_count ();
+  for (hb_codepoint_t lookup_index = -1; hb_set_next (lookup_indices, &lookup_index);)
+  {
+    if (lookup_index >= lookup_count)
+      break;
+    lookup_t *lookup = lookups.push ();
+    if (unlikely (!lookup))
+      break;
+
+    lookup->index = lookup_index;
+    lookup->accel = gsub.get_lookup (lookup_index).matches_single_glyph () ?
+		    &hb_ot_layout_from_face (face)->gsub_accels[lookup_index] : NULL;
+  }
+}
+
+void
+hb_ot_layout_closure_t::fini (void)
+{
+  lookups.finish ();
+}
+
+void
+hb_ot_layout_closure_t::closure (hb_set_t *glyphs, const hb_set_t *added,
+				 hb_set_t *new_glyphs) const
+{
+  const OT::GSUB &gsub = _get_gsub (face);
+  hb_set_t old, delta;
+  old.init ();
+  delta.init ();
+  delta.set (added);
+
+  for (unsigned int round = 0; !delta.is_empty (); round++)
+  {
+    hb_set_digest_t delta_digest;
+    delta_digest.init ();
+    for (hb_codepoint_t first, last = -1; hb_set_next_range (&delta, &first, &last);)
+      delta_digest.add_range (first, last);
+
+    old.set (glyphs);
+    unsigned int visited = 0;
+    for (unsigned int i = 0; i < lookups.len; i++)
+    {
+      const lookup_t &lookup = lookups[i];
+      if (lookup.accel && !lookup.accel->may_have (delta_digest))
+	continue;
+      OT::hb_closure_context_t c (face, glyphs);
+      gsub.get_lookup (lookup.index).closure (&c);
+      visited++;
+    }
+
+    delta.set (glyphs);
+    delta.subtract (&old);
+    if (new_glyphs)
+      new_glyphs->union_ (&delta);
+    DEBUG_MSG (CLOSURE, NULL, "round %u: visited %u of %u lookups, added %u glyphs",
+	       round, visited, lookups.len, delta.get_population ());
+  }
+
+  delta.fini ();
+  old.fini ();
+}
+
 /*
  * OT::GPOS
  */
@@ -859,6 +1098,23 @@ struct GPOSProxy
 };
 
 
+/* Returns the first glyph in [start, end) that has the lookup's mask and
+ * may be covered by it, or end.  Many lookups, such as the positional
+ * Arabic forms or those of user features with a range, apply to few
+ * glyphs; this keeps the loop over the others short. */
+static inline unsigned int
+next_candidate (const hb_glyph_info_t *info,
+		unsigned int start,
+		unsigned int end,
+		hb_mask_t lookup_mask,
+		const hb_ot_layout_lookup_accelerator_t &accel)
+{
+  for (unsigned int i = start; i < end; i++)
+    if ((info[i].mask & lookup_mask) && accel.may_have (info[i].codepoint))
+      return i;
+  return end;
+}
+
 template <typename Obj>
 static inline bool
 apply_forward (OT::hb_apply_context_t *c,
@@ -869,9 +1125,16 @@ apply_forward (OT::hb_apply_context_t *c,
   hb_buffer_t *buffer = c->buffer;
   while (buffer->idx < buffer->len)
   {
-    if (accel.may_have (buffer->cur().codepoint) &&
-	(buffer->cur().mask & c->lookup_mask) &&
-	c->check_glyph_property (&buffer->cur(), c->lookup_props) &&
+    unsigned int i = next_candidate (buffer->info, buffer->idx, buffer->len, c->lookup_mask, accel);
+    if (i > buffer->idx)
+    {
+      /* Copy the skipped glyphs to the output in one go. */
+      buffer->next_glyphs (i - buffer->idx);
+      if (unlikely (buffer->idx != i) || i == buffer->len)
+	break;
+    }
+
+    if (c->check_glyph_property (&buffer->cur(), c->lookup_props) &&
 	obj.apply (c))
       ret = true;
     else
@@ -947,11 +1210,13 @@ apply_string (OT::hb_apply_context_t *c,
     buffer->idx = 0;
 
     bool ret;
-    if (lookup.get_subtable_count () == 1)
+    if (lookup.get_subtable_count () == 1 && !accel.has_compiled_subtables ())
     {
       hb_apply_forward_context_t c_forward (c, accel);
       ret = lookup.dispatch (&c_forward);
     }
+    else if (likely (accel.has_subtables ()))
+      ret = apply_forward (c, accel, accel);
     else
       ret = apply_forward (c, lookup, accel);
     if (ret)
@@ -969,10 +1234,25 @@ apply_string (OT::hb_apply_context_t *c,
       buffer->remove_output ();
     buffer->idx = buffer->len - 1;
 
-    apply_backward (c, lookup, accel);
+    if (likely (accel.has_subtables ()))
+      apply_backward (c, accel, accel);
+    else
+      apply_backward (c, lookup, accel);
   }
 }
 
+/* Digest of the glyphs in the buffer, to skip lookups that cannot
+ * apply to any of them. */
+static inline void
+buffer_digest (const hb_buffer_t *buffer, hb_set_digest_t *digest)
+{
+  digest->init ();
+  const hb_glyph_info_t *info = buffer->info;
+  unsigned int count = buffer->len;
+  for (unsigned int i = 0; i < count; i++)
+    digest->add (info[i].codepoint);
+}
+
 template <typename Proxy>
 inline void hb_ot_map_t::apply (const Proxy &proxy,
 				const hb_ot_shape_plan_t *plan,
@@ -984,11 +1264,19 @@ inline void hb_ot_map_t::apply (const Proxy &proxy,
   OT::hb_apply_context_t c (table_index, font, buffer);
   c.set_recurse_func (Proxy::Lookup::apply_recurse_func);
 
+  /* Substitutions add the glyphs they output to the digest as they go;
+   * glyphs they remove stay in it, which is harmless. */
+  hb_set_digest_t digest;
+  buffer_digest (buffer, &digest);
+  c.set_buffer_digest (&digest);
+
   for (unsigned int stage_index = 0; stage_index < stages[table_index].len; stage_index++) {
     const stage_map_t *stage = &stages[table_index][stage_index];
     for (; i < stage->last_lookup; i++)
     {
       unsigned int lookup_index = lookups[table_index][i].index;
+      if (!proxy.accels[lookup_index].may_have (digest))
+	continue;
       c.set_lookup_mask (lookups[table_index][i].mask);
       c.set_auto_zwj (lookups[table_index][i].auto_zwj);
       apply_string<Proxy> (&c,
@@ -1000,6 +1288,7 @@ inline void hb_ot_map_t::apply (const Proxy &proxy,
     {
       buffer->clear_output ();
       stage->pause_func (plan, font, buffer);
+      buffer_digest (buffer, &digest);
     }
   }
 }
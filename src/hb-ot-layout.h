@@ -257,6 +257,11 @@ hb_ot_layout_lookup_substitute_closure (hb_face_t    *face,
 				        hb_set_t     *glyphs
 					/*TODO , hb_bool_t  inclusive */);
 
+void
+hb_ot_layout_lookups_substitute_closure (hb_face_t      *face,
+					 const hb_set_t *lookups,
+					 hb_set_t       *glyphs);
+
 #ifdef HB_NOT_IMPLEMENTED
 /* Note: You better have GDEF when using this API, or marks won't do much. */
 hb_bool_t
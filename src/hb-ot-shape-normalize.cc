@@ -284,6 +284,36 @@ compare_combining_class (const hb_glyph_info_t *pa, const hb_glyph_info_t *pb)
   return a < b ? -1 : a == b ? 0 : +1;
 }
 
+/* Sorts the run of non-zero combining classes starting at start,
+ * and returns its end. */
+static inline unsigned int
+reorder_marks (hb_buffer_t *buffer, unsigned int start)
+{
+  unsigned int count = buffer->len;
+  unsigned int end;
+  for (end = start + 1; end < count; end++)
+    if (_hb_glyph_info_get_modified_combining_class (&buffer->info[end]) == 0)
+      break;
+
+  /* We are going to do a bubble-sort.  Only do this if the
+   * sequence is short.  Doing it on long sequences can result
+   * in an O(n^2) DoS. */
+  if (end - start <= 10)
+    hb_bubble_sort (buffer->info + start, end - start, compare_combining_class);
+
+  return end;
+}
+
+/* Whether the reorder and recompose rounds may touch this character:
+ * the former only moves non-zero combining classes, and the latter
+ * only composes marks. */
+static inline bool
+is_mark_or_combining (const hb_glyph_info_t *info)
+{
+  return _hb_glyph_info_get_modified_combining_class (info) ||
+	 HB_UNICODE_GENERAL_CATEGORY_IS_MARK (_hb_glyph_info_get_general_category (info));
+}
+
 
 void
 _hb_ot_shape_normalize (const hb_ot_shape_plan_t *plan,
@@ -308,17 +338,19 @@ _hb_ot_shape_normalize (const hb_ot_shape_plan_t *plan,
 			      mode != HB_OT_SHAPE_NORMALIZATION_MODE_COMPOSED_DIACRITICS_NO_SHORT_CIRCUIT);
   unsigned int count;
 
-  /* We do a fairly straightforward yet custom normalization process in three
-   * separate rounds: decompose, reorder, recompose (if desired).  Currently
-   * this makes two buffer swaps.  We can make it faster by moving the last
-   * two rounds into the inner loop for the first round, but it's more readable
-   * this way. */
+  /* We do a fairly straightforward yet custom normalization process in two
+   * rounds: decompose, then reorder and recompose (if desired) in a single
+   * pass, where each run of marks is sorted right before it is recomposed.
+   * Text that has no marks after decomposition, like most text in simple
+   * scripts, is left alone after the first round. */
 
 
   /* First round, decompose */
 
   buffer->clear_output ();
   count = buffer->len;
+  unsigned int mapped_end = 0; /* Characters before this have their glyph_index() set. */
+  bool has_marks = false;
   for (buffer->idx = 0; buffer->idx < count;)
   {
     unsigned int end;
@@ -326,53 +358,74 @@ _hb_ot_shape_normalize (const hb_ot_shape_plan_t *plan,
       if (buffer->cur().cluster != buffer->info[end].cluster)
         break;
 
+    /* Short-circuiting single-character clusters just need the nominal
+     * glyph; map runs of them with one call into the font.  ASCII has no
+     * canonical decompositions, so it ends up with the nominal glyph even
+     * when not short-circuiting. */
+    if ((might_short_circuit || buffer->cur().codepoint < 0x80u) && end == buffer->idx + 1)
+    {
+      if (buffer->idx >= mapped_end)
+      {
+	unsigned int n = count - buffer->idx;
+	if (!might_short_circuit)
+	  for (n = 1; buffer->idx + n < count && buffer->info[buffer->idx + n].codepoint < 0x80u; n++)
+	    ;
+	mapped_end = buffer->idx + font->get_glyphs (n,
+						     &buffer->cur().codepoint, sizeof (buffer->info[0]),
+						     &buffer->cur().glyph_index(), sizeof (buffer->info[0]));
+      }
+      if (buffer->idx < mapped_end)
+      {
+	has_marks = has_marks || is_mark_or_combining (&buffer->cur());
+	buffer->next_glyph ();
+	continue;
+      }
+    }
+
+    unsigned int out_start = buffer->out_len;
     decompose_cluster (&c, end, might_short_circuit, always_short_circuit);
+    for (unsigned int i = out_start; i < buffer->out_len && !has_marks; i++)
+      has_marks = is_mark_or_combining (&buffer->out_info[i]);
   }
   buffer->swap_buffers ();
 
-
-  /* Second round, reorder (inplace) */
-
-  count = buffer->len;
-  for (unsigned int i = 0; i < count; i++)
-  {
-    if (_hb_glyph_info_get_modified_combining_class (&buffer->info[i]) == 0)
-      continue;
-
-    unsigned int end;
-    for (end = i + 1; end < count; end++)
-      if (_hb_glyph_info_get_modified_combining_class (&buffer->info[end]) == 0)
-        break;
-
-    /* We are going to do a bubble-sort.  Only do this if the
-     * sequence is short.  Doing it on long sequences can result
-     * in an O(n^2) DoS. */
-    if (end - i > 10) {
-      i = end;
-      continue;
-    }
-
-    hb_bubble_sort (buffer->info + i, end - i, compare_combining_class);
-
-    i = end;
-  }
+  if (!has_marks)
+    return;
 
 
   if (mode == HB_OT_SHAPE_NORMALIZATION_MODE_NONE ||
       mode == HB_OT_SHAPE_NORMALIZATION_MODE_DECOMPOSED)
+  {
+    /* Second round, reorder (inplace) */
+
+    count = buffer->len;
+    for (unsigned int i = 0; i < count; i++)
+      if (_hb_glyph_info_get_modified_combining_class (&buffer->info[i]) != 0)
+	i = reorder_marks (buffer, i);
     return;
+  }
 
-  /* Third round, recompose */
+  /* Second round, reorder and recompose */
 
   /* As noted in the comment earlier, we don't try to combine
-   * ccc=0 chars with their previous Starter. */
+   * ccc=0 chars with their previous Starter.
+   *
+   * Runs of marks are sorted inplace ahead of idx, which the out-buffer
+   * never overtakes. */
 
   buffer->clear_output ();
   count = buffer->len;
   unsigned int starter = 0;
+  unsigned int sorted_end = 0; /* Runs of marks before this are sorted. */
+  if (_hb_glyph_info_get_modified_combining_class (&buffer->cur()) != 0)
+    sorted_end = reorder_marks (buffer, 0);
   buffer->next_glyph ();
   while (buffer->idx < count)
   {
+    if (buffer->idx >= sorted_end &&
+	_hb_glyph_info_get_modified_combining_class (&buffer->cur()) != 0)
+      sorted_end = reorder_marks (buffer, buffer->idx);
+
     hb_codepoint_t composed, glyph;
     if (/* We don't try to compose a non-mark character with it's preceding starter.
 	 * This is both an optimization to avoid trying to compose every two neighboring
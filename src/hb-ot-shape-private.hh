@@ -101,4 +101,19 @@ struct hb_ot_shape_planner_t
 };
 
 
+struct hb_ot_shape_closure_t
+{
+  hb_object_header_t header;
+  ASSERT_POD ();
+
+  hb_font_t *font;
+  hb_bool_t mirror;
+
+  /* Keeps the lookups of the plan between calls, such that adding text
+   * only visits what the new glyphs may reach. */
+  hb_ot_layout_closure_t layout;
+  hb_set_t glyphs;
+};
+
+
 #endif /* HB_OT_SHAPE_PRIVATE_HH */
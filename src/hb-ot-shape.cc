@@ -116,8 +116,7 @@ hb_ot_shape_collect_features (hb_ot_shape_planner_t          *planner,
   for (unsigned int i = 0; i < num_user_features; i++) {
     const hb_feature_t *feature = &user_features[i];
     map->add_feature (feature->tag, feature->value,
-		      (feature->start == 0 && feature->end == (unsigned int) -1) ?
-		       F_GLOBAL : F_NONE);
+		      hb_feature_is_global (feature) ? F_GLOBAL : F_NONE);
   }
 }
 
@@ -228,8 +227,24 @@ hb_set_unicode_props (hb_buffer_t *buffer)
 {
   unsigned int count = buffer->len;
   hb_glyph_info_t *info = buffer->info;
+  hb_unicode_funcs_t *unicode = buffer->unicode;
+
+  if (unicode->props)
+  {
+    /* Built-in Unicode functions look everything up at once. */
+    hb_unicode_props_t props[64];
+    for (unsigned int start = 0; start < count; start += ARRAY_LENGTH (props))
+    {
+      unsigned int n = MIN (count - start, ARRAY_LENGTH (props));
+      unicode->props (n, &info[start].codepoint, sizeof (info[0]), props);
+      for (unsigned int i = 0; i < n; i++)
+	_hb_glyph_info_set_unicode_props (&info[start + i], unicode, props[i]);
+    }
+    return;
+  }
+
   for (unsigned int i = 0; i < count; i++)
-    _hb_glyph_info_set_unicode_props (&info[i], buffer->unicode);
+    _hb_glyph_info_set_unicode_props (&info[i], unicode);
 }
 
 static void
@@ -303,6 +318,29 @@ hb_ot_mirror_chars (hb_ot_shape_context_t *c)
 
   unsigned int count = buffer->len;
   hb_glyph_info_t *info = buffer->info;
+
+  if (unicode->props)
+  {
+    /* Only look up the mirroring of characters with the Bidi_Mirrored
+     * property; no others have one. */
+    hb_unicode_props_t props[64];
+    for (unsigned int start = 0; start < count; start += ARRAY_LENGTH (props))
+    {
+      unsigned int n = MIN (count - start, ARRAY_LENGTH (props));
+      unicode->props (n, &info[start].codepoint, sizeof (info[0]), props);
+      for (unsigned int i = start; i < start + n; i++)
+      {
+	hb_codepoint_t codepoint = likely (!props[i - start].mirrored) ?
+				   info[i].codepoint : unicode->mirroring (info[i].codepoint);
+	if (likely (codepoint == info[i].codepoint))
+	  info[i].mask |= rtlm_mask;
+	else
+	  info[i].codepoint = codepoint;
+      }
+    }
+    return;
+  }
+
   for (unsigned int i = 0; i < count; i++) {
     hb_codepoint_t codepoint = unicode->mirroring (info[i].codepoint);
     if (likely (codepoint == info[i].codepoint))
@@ -372,7 +410,7 @@ hb_ot_shape_setup_masks (hb_ot_shape_context_t *c)
   for (unsigned int i = 0; i < c->num_user_features; i++)
   {
     const hb_feature_t *feature = &c->user_features[i];
-    if (!(feature->start == 0 && feature->end == (unsigned int)-1)) {
+    if (!hb_feature_is_global (feature)) {
       unsigned int shift;
       hb_mask_t mask = map->get_mask (feature->tag, &shift);
       buffer->set_masks (feature->value << shift, mask, feature->start, feature->end);
@@ -519,18 +557,23 @@ hb_ot_position_default (hb_ot_shape_context_t *c)
   unsigned int count = c->buffer->len;
   hb_glyph_info_t *info = c->buffer->info;
   hb_glyph_position_t *pos = c->buffer->pos;
+
+  /* Positions were cleared in hb_ot_layout_position_start(), so only
+   * the advance along the direction needs to be filled in. */
+  if (HB_DIRECTION_IS_HORIZONTAL (direction))
+    c->font->get_glyph_h_advances (count,
+				   &info[0].codepoint, sizeof (info[0]),
+				   &pos[0].x_advance, sizeof (pos[0]));
+  else
+    c->font->get_glyph_v_advances (count,
+				   &info[0].codepoint, sizeof (info[0]),
+				   &pos[0].y_advance, sizeof (pos[0]));
+
   for (unsigned int i = 0; i < count; i++)
-  {
-    c->font->get_glyph_advance_for_direction (info[i].codepoint,
-					      direction,
-					      &pos[i].x_advance,
-					      &pos[i].y_advance);
     c->font->subtract_glyph_origin_for_direction (info[i].codepoint,
 						  direction,
 						  &pos[i].x_offset,
 						  &pos[i].y_offset);
-
-  }
 }
 
 static inline bool
@@ -797,13 +840,215 @@ hb_ot_shape_glyphs_closure (hb_font_t          *font,
   hb_ot_shape_plan_collect_lookups (shape_plan, HB_OT_TAG_GSUB, &lookups);
 
   /* And find transitive closure. */
-  hb_set_t copy;
-  copy.init ();
-  do {
-    copy.set (glyphs);
-    for (hb_codepoint_t lookup_index = -1; hb_set_next (&lookups, &lookup_index);)
-      hb_ot_layout_lookup_substitute_closure (font->face, lookup_index, glyphs);
-  } while (!copy.is_equal (glyphs));
+  hb_ot_layout_lookups_substitute_closure (font->face, &lookups, glyphs);
+  lookups.fini ();
 
   hb_shape_plan_destroy (shape_plan);
 }
+
+
+/**
+ * hb_ot_shape_closure_create: (Xconstructor)
+ * @font: a font.
+ * @props: segment properties of the text to add.
+ * @features: (array length=num_features):
+ * @num_features:
+ *
+ * Creates an empty glyph closure for the GSUB lookups that shaping
+ * text with @props and @features may apply.  Text added to it with
+ * hb_ot_shape_closure_add_buffer() only costs what its new glyphs may
+ * reach, which suits subsets that grow over time.
+ *
+ * Return value: (transfer full):
+ *
+ * Since: 0.9.41
+ **/
+hb_ot_shape_closure_t *
+hb_ot_shape_closure_create (hb_font_t                     *font,
+			    const hb_segment_properties_t *props,
+			    const hb_feature_t            *features,
+			    unsigned int                   num_features)
+{
+  hb_ot_shape_closure_t *closure;
+
+  if (unlikely (!font || !props))
+    return hb_ot_shape_closure_get_empty ();
+  if (!(closure = hb_object_create<hb_ot_shape_closure_t> ()))
+    return hb_ot_shape_closure_get_empty ();
+
+  const char *shapers[] = {"ot", NULL};
+  hb_shape_plan_t *shape_plan = hb_shape_plan_create_cached (font->face, props,
+							     features, num_features, shapers);
+
+  hb_set_t lookups;
+  lookups.init ();
+  hb_ot_shape_plan_collect_lookups (shape_plan, HB_OT_TAG_GSUB, &lookups);
+
+  closure->font = hb_font_reference (font);
+  closure->mirror = hb_script_get_horizontal_direction (props->script) == HB_DIRECTION_RTL;
+  closure->layout.init (font->face, &lookups);
+  closure->glyphs.init ();
+
+  lookups.fini ();
+  hb_shape_plan_destroy (shape_plan);
+
+  return closure;
+}
+
+/**
+ * hb_ot_shape_closure_get_empty:
+ *
+ * Return value: (transfer full):
+ *
+ * Since: 0.9.41
+ **/
+hb_ot_shape_closure_t *
+hb_ot_shape_closure_get_empty (void)
+{
+  static const hb_ot_shape_closure_t _hb_ot_shape_closure_nil = {
+    HB_OBJECT_HEADER_STATIC,
+
+    NULL,  /* font */
+    false, /* mirror */
+
+    {
+      NULL,			/* face */
+      HB_PREALLOCED_ARRAY_INIT	/* lookups */
+    },
+    {
+      HB_OBJECT_HEADER_STATIC,
+      true,  /* in_error */
+      false, /* inverted */
+
+      HB_PREALLOCED_ARRAY_INIT, /* page_map */
+      HB_PREALLOCED_ARRAY_INIT  /* pages */
+    }
+  };
+
+  return const_cast<hb_ot_shape_closure_t *> (&_hb_ot_shape_closure_nil);
+}
+
+/**
+ * hb_ot_shape_closure_reference: (skip)
+ * @closure: a closure.
+ *
+ * Return value: (transfer full):
+ *
+ * Since: 0.9.41
+ **/
+hb_ot_shape_closure_t *
+hb_ot_shape_closure_reference (hb_ot_shape_closure_t *closure)
+{
+  return hb_object_reference (closure);
+}
+
+/**
+ * hb_ot_shape_closure_destroy: (skip)
+ * @closure: a closure.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_ot_shape_closure_destroy (hb_ot_shape_closure_t *closure)
+{
+  if (!hb_object_destroy (closure)) return;
+
+  closure->glyphs.fini ();
+  closure->layout.fini ();
+  hb_font_destroy (closure->font);
+
+  free (closure);
+}
+
+/**
+ * hb_ot_shape_closure_set_user_data: (skip)
+ * @closure: a closure.
+ * @key:
+ * @data:
+ * @destroy (closure data):
+ * @replace:
+ *
+ * Return value:
+ *
+ * Since: 0.9.41
+ **/
+hb_bool_t
+hb_ot_shape_closure_set_user_data (hb_ot_shape_closure_t *closure,
+				   hb_user_data_key_t    *key,
+				   void *                 data,
+				   hb_destroy_func_t      destroy,
+				   hb_bool_t              replace)
+{
+  return hb_object_set_user_data (closure, key, data, destroy, replace);
+}
+
+/**
+ * hb_ot_shape_closure_get_user_data: (skip)
+ * @closure: a closure.
+ * @key:
+ *
+ * Return value: (transfer none):
+ *
+ * Since: 0.9.41
+ **/
+void *
+hb_ot_shape_closure_get_user_data (hb_ot_shape_closure_t *closure,
+				   hb_user_data_key_t    *key)
+{
+  return hb_object_get_user_data (closure, key);
+}
+
+/**
+ * hb_ot_shape_closure_add_buffer:
+ * @closure: a closure.
+ * @buffer: a buffer holding Unicode text.
+ * @new_glyphs: (allow-none): set to add the glyphs that become reachable to.
+ *
+ * Adds to @closure the glyphs of the characters in @buffer, and all
+ * glyphs that substitutions may reach from them and the glyphs already
+ * in @closure.  The segment properties of @buffer are not used; those
+ * given to hb_ot_shape_closure_create() are.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_ot_shape_closure_add_buffer (hb_ot_shape_closure_t *closure,
+				hb_buffer_t           *buffer,
+				hb_set_t              *new_glyphs)
+{
+  if (unlikely (hb_object_is_inert (closure)))
+    return;
+
+  hb_set_t added;
+  added.init ();
+
+  unsigned int count = buffer->len;
+  hb_glyph_info_t *info = buffer->info;
+  for (unsigned int i = 0; i < count; i++)
+    add_char (closure->font, buffer->unicode, closure->mirror, info[i].codepoint, &added);
+  added.subtract (&closure->glyphs);
+
+  if (!added.is_empty ())
+  {
+    if (new_glyphs)
+      new_glyphs->union_ (&added);
+    closure->glyphs.union_ (&added);
+    closure->layout.closure (&closure->glyphs, &added, new_glyphs);
+  }
+
+  added.fini ();
+}
+
+/**
+ * hb_ot_shape_closure_get_glyphs:
+ * @closure: a closure.
+ * @glyphs: set to add the glyphs of @closure to.
+ *
+ * Since: 0.9.41
+ **/
+void
+hb_ot_shape_closure_get_glyphs (hb_ot_shape_closure_t *closure,
+				hb_set_t              *glyphs)
+{
+  glyphs->union_ (&closure->glyphs);
+}
@@ -43,6 +43,45 @@ hb_ot_shape_glyphs_closure (hb_font_t          *font,
 			    unsigned int        num_features,
 			    hb_set_t           *glyphs);
 
+
+typedef struct hb_ot_shape_closure_t hb_ot_shape_closure_t;
+
+hb_ot_shape_closure_t *
+hb_ot_shape_closure_create (hb_font_t                     *font,
+			    const hb_segment_properties_t *props,
+			    const hb_feature_t            *features,
+			    unsigned int                   num_features);
+
+hb_ot_shape_closure_t *
+hb_ot_shape_closure_get_empty (void);
+
+hb_ot_shape_closure_t *
+hb_ot_shape_closure_reference (hb_ot_shape_closure_t *closure);
+
+void
+hb_ot_shape_closure_destroy (hb_ot_shape_closure_t *closure);
+
+hb_bool_t
+hb_ot_shape_closure_set_user_data (hb_ot_shape_closure_t *closure,
+				   hb_user_data_key_t    *key,
+				   void *                 data,
+				   hb_destroy_func_t      destroy,
+				   hb_bool_t              replace);
+
+void *
+hb_ot_shape_closure_get_user_data (hb_ot_shape_closure_t *closure,
+				   hb_user_data_key_t    *key);
+
+void
+hb_ot_shape_closure_add_buffer (hb_ot_shape_closure_t *closure,
+				hb_buffer_t           *buffer,
+				hb_set_t              *new_glyphs /* OUT, may be NULL */);
+
+void
+hb_ot_shape_closure_get_glyphs (hb_ot_shape_closure_t *closure,
+				hb_set_t              *glyphs /* OUT */);
+
+
 void
 hb_ot_shape_plan_collect_lookups (hb_shape_plan_t *shape_plan,
 				  hb_tag_t         table_tag,
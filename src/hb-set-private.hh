@@ -79,6 +79,10 @@ struct hb_set_digest_lowest_bits_t
     return !!(mask & mask_for (g));
   }
 
+  inline bool may_have (const hb_set_digest_lowest_bits_t &o) const {
+    return !!(mask & o.mask);
+  }
+
   private:
 
   static inline mask_t mask_for (hb_codepoint_t g) {
@@ -111,6 +115,11 @@ struct hb_set_digest_combiner_t
     return head.may_have (g) && tail.may_have (g);
   }
 
+  /* Whether the two sets may have a glyph in common. */
+  inline bool may_have (const hb_set_digest_combiner_t &o) const {
+    return head.may_have (o.head) && tail.may_have (o.tail);
+  }
+
   private:
   head_t head;
   tail_t tail;
@@ -141,31 +150,193 @@ typedef hb_set_digest_combiner_t
  */
 
 
-/* TODO Make this faster and memmory efficient. */
+/* A sparse bitset, made of fixed-size pages of bits that are allocated as
+ * needed.  Pages are kept in the order they were allocated; page_map holds
+ * one entry per page, sorted by the page's major number, to look them up.
+ *
+ * Inversion is done by flag; the pages then hold the numbers *not* in the
+ * set.  The universe is [0, HB_SET_VALUE_INVALID).  Empty pages are fine
+ * and are not reclaimed until the set is cleared. */
 
 struct hb_set_t
 {
-  friend struct hb_frozen_set_t;
+  struct page_map_t
+  {
+    uint32_t major;
+    uint32_t index;
+  };
+
+  struct page_t
+  {
+    typedef unsigned long long int elt_t;
+    static const unsigned int PAGE_BITS = 512;
+    static const unsigned int ELT_BITS = sizeof (elt_t) * 8;
+    static const unsigned int ELT_MASK = ELT_BITS - 1;
+    static const unsigned int LEN = PAGE_BITS / ELT_BITS;
+    static const unsigned int PAGE_MASK = PAGE_BITS - 1;
+
+    inline void init0 (void) { memset (v, 0, sizeof (v)); }
+    inline void init1 (void) { memset (v, 0xff, sizeof (v)); }
+
+    inline elt_t &elt (hb_codepoint_t g) { return v[(g & PAGE_MASK) / ELT_BITS]; }
+    inline elt_t const &elt (hb_codepoint_t g) const { return v[(g & PAGE_MASK) / ELT_BITS]; }
+    static inline elt_t mask (hb_codepoint_t g) { return elt_t (1) << (g & ELT_MASK); }
+
+    inline void add (hb_codepoint_t g) { elt (g) |= mask (g); }
+    inline void del (hb_codepoint_t g) { elt (g) &= ~mask (g); }
+    inline bool has (hb_codepoint_t g) const { return !!(elt (g) & mask (g)); }
+
+    /* a and b must be in this page, with a <= b. */
+    inline void add_range (hb_codepoint_t a, hb_codepoint_t b)
+    {
+      elt_t *la = &elt (a);
+      elt_t *lb = &elt (b);
+      if (la == lb)
+	*la |= (mask (b) << 1) - mask (a);
+      else
+      {
+	*la |= ~(mask (a) - 1);
+	for (la++; la < lb; la++)
+	  *la = (elt_t) -1;
+	*lb |= (mask (b) << 1) - 1;
+      }
+    }
+    inline void del_range (hb_codepoint_t a, hb_codepoint_t b)
+    {
+      elt_t *la = &elt (a);
+      elt_t *lb = &elt (b);
+      if (la == lb)
+	*la &= ~((mask (b) << 1) - mask (a));
+      else
+      {
+	*la &= mask (a) - 1;
+	for (la++; la < lb; la++)
+	  *la = 0;
+	*lb &= ~((mask (b) << 1) - 1);
+      }
+    }
+
+    inline bool is_empty (void) const
+    {
+      for (unsigned int i = 0; i < LEN; i++)
+	if (v[i])
+	  return false;
+      return true;
+    }
+    inline bool is_equal (const page_t *other) const
+    {
+      return 0 == memcmp (v, other->v, sizeof (v));
+    }
+    inline unsigned int get_population (void) const
+    {
+      unsigned int pop = 0;
+      for (unsigned int i = 0; i < LEN; i++)
+	pop += popcount (v[i]);
+      return pop;
+    }
+
+    /* Returns the index of the first bit at or after i that is set,
+     * or cleared if invert is true; or PAGE_BITS if there is none. */
+    inline unsigned int find (unsigned int i, bool invert) const
+    {
+      elt_t flip = invert ? (elt_t) -1 : 0;
+      unsigned int j = i / ELT_BITS;
+      elt_t m = (v[j] ^ flip) & ~(mask (i) - 1);
+      while (!m)
+      {
+	if (++j == LEN)
+	  return PAGE_BITS;
+	m = v[j] ^ flip;
+      }
+      return j * ELT_BITS + ctz (m);
+    }
+    /* Same, going backwards from i; returns (unsigned) -1 if there is none. */
+    inline unsigned int find_backward (unsigned int i, bool invert) const
+    {
+      elt_t flip = invert ? (elt_t) -1 : 0;
+      unsigned int j = i / ELT_BITS;
+      elt_t m = (v[j] ^ flip) & ((mask (i) << 1) - 1);
+      while (!m)
+      {
+	if (!j--)
+	  return (unsigned int) -1;
+	m = v[j] ^ flip;
+      }
+      return j * ELT_BITS + (ELT_BITS - 1 - clz (m));
+    }
+
+    static inline unsigned int popcount (elt_t e)
+    {
+      return _hb_popcount32 ((uint32_t) e) + _hb_popcount32 ((uint32_t) (e >> 32));
+    }
+    static inline unsigned int ctz (elt_t e)
+    {
+      return (uint32_t) e ? _hb_ctz ((uint32_t) e) : 32 + _hb_ctz ((uint32_t) (e >> 32));
+    }
+    static inline unsigned int clz (elt_t e)
+    {
+      return (e >> 32) ? 32 - _hb_bit_storage ((uint32_t) (e >> 32))
+		       : 64 - _hb_bit_storage ((uint32_t) e);
+    }
+
+    elt_t v[LEN];
+  };
+  ASSERT_STATIC (page_t::PAGE_BITS == sizeof (page_t) * 8);
+
+  /* Word-wise operations for process().  passthru_left / passthru_right
+   * tell whether bits from only one side survive the operation. */
+  struct or_op_t {
+    static const bool passthru_left = true, passthru_right = true;
+    static inline page_t::elt_t op (page_t::elt_t a, page_t::elt_t b) { return a | b; }
+  };
+  struct and_op_t {
+    static const bool passthru_left = false, passthru_right = false;
+    static inline page_t::elt_t op (page_t::elt_t a, page_t::elt_t b) { return a & b; }
+  };
+  struct minus_op_t {
+    static const bool passthru_left = true, passthru_right = false;
+    static inline page_t::elt_t op (page_t::elt_t a, page_t::elt_t b) { return a & ~b; }
+  };
+  struct rminus_op_t {
+    static const bool passthru_left = false, passthru_right = true;
+    static inline page_t::elt_t op (page_t::elt_t a, page_t::elt_t b) { return b & ~a; }
+  };
+  struct xor_op_t {
+    static const bool passthru_left = true, passthru_right = true;
+    static inline page_t::elt_t op (page_t::elt_t a, page_t::elt_t b) { return a ^ b; }
+  };
 
   hb_object_header_t header;
   ASSERT_POD ();
   bool in_error;
+  bool inverted;
+  hb_prealloced_array_t<page_map_t, 8> page_map;
+  hb_prealloced_array_t<page_t, 1> pages;
 
   inline void init (void) {
     hb_object_init (this);
-    clear ();
+    in_error = false;
+    inverted = false;
+    page_map.init ();
+    pages.init ();
   }
   inline void fini (void) {
+    page_map.finish ();
+    pages.finish ();
   }
   inline void clear (void) {
     if (unlikely (hb_object_is_inert (this)))
       return;
     in_error = false;
-    memset (elts, 0, sizeof elts);
+    inverted = false;
+    page_map.shrink (0);
+    pages.shrink (0);
   }
   inline bool is_empty (void) const {
-    for (unsigned int i = 0; i < ARRAY_LENGTH (elts); i++)
-      if (elts[i])
+    if (unlikely (inverted))
+      return get_population () == 0;
+    for (unsigned int i = 0; i < pages.len; i++)
+      if (!pages[i].is_empty ())
         return false;
     return true;
   }
@@ -173,107 +344,195 @@ struct hb_set_t
   {
     if (unlikely (in_error)) return;
     if (unlikely (g == INVALID)) return;
-    if (unlikely (g > MAX_G)) return;
-    elt (g) |= mask (g);
+    if (unlikely (inverted)) { del_raw (g); return; }
+    page_t *page = page_for_insert (g);
+    if (unlikely (!page)) return;
+    page->add (g);
   }
   inline void add_range (hb_codepoint_t a, hb_codepoint_t b)
   {
     if (unlikely (in_error)) return;
-    /* TODO Speedup */
-    for (unsigned int i = a; i < b + 1; i++)
-      add (i);
+    if (unlikely (a > b || a == INVALID || b == INVALID)) return;
+    if (unlikely (inverted)) { del_range_raw (a, b); return; }
+    unsigned int ma = get_major (a);
+    unsigned int mb = get_major (b);
+    if (ma == mb)
+    {
+      page_t *page = page_for_insert (a);
+      if (unlikely (!page)) return;
+      page->add_range (a, b);
+      return;
+    }
+    page_t *page = page_for_insert (a);
+    if (unlikely (!page)) return;
+    page->add_range (a, major_start (ma + 1) - 1);
+    for (unsigned int m = ma + 1; m < mb; m++)
+    {
+      page = page_for_insert (major_start (m));
+      if (unlikely (!page)) return;
+      page->init1 ();
+    }
+    page = page_for_insert (b);
+    if (unlikely (!page)) return;
+    page->add_range (major_start (mb), b);
   }
   inline void del (hb_codepoint_t g)
   {
     if (unlikely (in_error)) return;
-    if (unlikely (g > MAX_G)) return;
-    elt (g) &= ~mask (g);
+    if (unlikely (g == INVALID)) return;
+    if (unlikely (inverted))
+    {
+      page_t *page = page_for_insert (g);
+      if (unlikely (!page)) return;
+      page->add (g);
+      return;
+    }
+    del_raw (g);
   }
   inline void del_range (hb_codepoint_t a, hb_codepoint_t b)
   {
     if (unlikely (in_error)) return;
-    /* TODO Speedup */
-    for (unsigned int i = a; i < b + 1; i++)
-      del (i);
+    if (unlikely (a > b || a == INVALID || b == INVALID)) return;
+    if (unlikely (inverted))
+    {
+      /* Adding to the pages, which is what add_range() does uninverted. */
+      inverted = false;
+      add_range (a, b);
+      inverted = true;
+      return;
+    }
+    del_range_raw (a, b);
   }
   inline bool has (hb_codepoint_t g) const
   {
-    if (unlikely (g > MAX_G)) return false;
-    return !!(elt (g) & mask (g));
+    if (unlikely (g == INVALID)) return false;
+    const page_t *page = page_for (g);
+    return (page && page->has (g)) != inverted;
   }
   inline bool intersects (hb_codepoint_t first,
 			  hb_codepoint_t last) const
   {
-    if (unlikely (first > MAX_G)) return false;
-    if (unlikely (last  > MAX_G)) last = MAX_G;
-    unsigned int end = last + 1;
-    for (hb_codepoint_t i = first; i < end; i++)
-      if (has (i))
-        return true;
-    return false;
+    hb_codepoint_t c = first - 1;
+    return next (&c) && c <= last;
   }
   inline bool is_equal (const hb_set_t *other) const
   {
-    for (unsigned int i = 0; i < ELTS; i++)
-      if (elts[i] != other->elts[i])
-        return false;
+    if (inverted != other->inverted)
+      return false;
+
+    unsigned int na = page_map.len;
+    unsigned int nb = other->page_map.len;
+    unsigned int a = 0, b = 0;
+    while (a < na || b < nb)
+    {
+      if (b == nb || (a < na && page_map[a].major < other->page_map[b].major))
+      {
+	if (!page_at (a++).is_empty ())
+	  return false;
+      }
+      else if (a == na || page_map[a].major > other->page_map[b].major)
+      {
+	if (!other->page_at (b++).is_empty ())
+	  return false;
+      }
+      else
+      {
+	if (!page_at (a++).is_equal (&other->page_at (b++)))
+	  return false;
+      }
+    }
     return true;
   }
   inline void set (const hb_set_t *other)
   {
     if (unlikely (in_error)) return;
-    for (unsigned int i = 0; i < ELTS; i++)
-      elts[i] = other->elts[i];
+    if (unlikely (this == other)) return;
+    unsigned int count = other->pages.len;
+    if (unlikely (!resize (count))) return;
+    inverted = other->inverted;
+    if (!count) return;
+    memcpy (page_map.array, other->page_map.array, count * sizeof (page_map[0]));
+    memcpy (pages.array, other->pages.array, count * sizeof (pages[0]));
   }
   inline void union_ (const hb_set_t *other)
   {
     if (unlikely (in_error)) return;
-    for (unsigned int i = 0; i < ELTS; i++)
-      elts[i] |= other->elts[i];
+    if (!inverted)
+    {
+      if (!other->inverted)
+	process<or_op_t> (other);
+      else
+      {
+	process<rminus_op_t> (other);
+	inverted = true;
+      }
+    }
+    else
+    {
+      if (!other->inverted)
+	process<minus_op_t> (other);
+      else
+	process<and_op_t> (other);
+    }
   }
   inline void intersect (const hb_set_t *other)
   {
     if (unlikely (in_error)) return;
-    for (unsigned int i = 0; i < ELTS; i++)
-      elts[i] &= other->elts[i];
+    if (!inverted)
+    {
+      if (!other->inverted)
+	process<and_op_t> (other);
+      else
+	process<minus_op_t> (other);
+    }
+    else
+    {
+      if (!other->inverted)
+      {
+	process<rminus_op_t> (other);
+	inverted = false;
+      }
+      else
+	process<or_op_t> (other);
+    }
   }
   inline void subtract (const hb_set_t *other)
   {
     if (unlikely (in_error)) return;
-    for (unsigned int i = 0; i < ELTS; i++)
-      elts[i] &= ~other->elts[i];
+    if (!inverted)
+    {
+      if (!other->inverted)
+	process<minus_op_t> (other);
+      else
+	process<and_op_t> (other);
+    }
+    else
+    {
+      if (!other->inverted)
+	process<or_op_t> (other);
+      else
+      {
+	process<rminus_op_t> (other);
+	inverted = false;
+      }
+    }
   }
   inline void symmetric_difference (const hb_set_t *other)
   {
     if (unlikely (in_error)) return;
-    for (unsigned int i = 0; i < ELTS; i++)
-      elts[i] ^= other->elts[i];
+    process<xor_op_t> (other);
+    inverted = inverted != other->inverted;
   }
   inline void invert (void)
   {
     if (unlikely (in_error)) return;
-    for (unsigned int i = 0; i < ELTS; i++)
-      elts[i] = ~elts[i];
+    inverted = !inverted;
   }
   inline bool next (hb_codepoint_t *codepoint) const
   {
-    if (unlikely (*codepoint == INVALID)) {
-      hb_codepoint_t i = get_min ();
-      if (i != INVALID) {
-        *codepoint = i;
-	return true;
-      } else {
-	*codepoint = INVALID;
-        return false;
-      }
-    }
-    for (hb_codepoint_t i = *codepoint + 1; i < MAX_G + 1; i++)
-      if (has (i)) {
-        *codepoint = i;
-	return true;
-      }
-    *codepoint = INVALID;
-    return false;
+    hb_codepoint_t start = *codepoint == INVALID ? 0 : *codepoint + 1;
+    *codepoint = find (start, inverted);
+    return *codepoint != INVALID;
   }
   inline bool next_range (hb_codepoint_t *first, hb_codepoint_t *last) const
   {
@@ -286,108 +545,235 @@ struct hb_set_t
       return false;
     }
 
-    *last = *first = i;
-    while (next (&i) && i == *last + 1)
-      (*last)++;
+    *first = i;
+    *last = find (i + 1, !inverted) - 1;
 
     return true;
   }
 
   inline unsigned int get_population (void) const
   {
-    unsigned int count = 0;
-    for (unsigned int i = 0; i < ELTS; i++)
-      count += _hb_popcount32 (elts[i]);
-    return count;
+    unsigned int pop = 0;
+    for (unsigned int i = 0; i < pages.len; i++)
+      pop += pages[i].get_population ();
+    return inverted ? INVALID - pop : pop;
   }
   inline hb_codepoint_t get_min (void) const
   {
-    for (unsigned int i = 0; i < ELTS; i++)
-      if (elts[i])
-	for (unsigned int j = 0; j < BITS; j++)
-	  if (elts[i] & (1 << j))
-	    return i * BITS + j;
-    return INVALID;
+    return find (0, inverted);
   }
   inline hb_codepoint_t get_max (void) const
   {
-    for (unsigned int i = ELTS; i; i--)
-      if (elts[i - 1])
-	for (unsigned int j = BITS; j; j--)
-	  if (elts[i - 1] & (1 << (j - 1)))
-	    return (i - 1) * BITS + (j - 1);
-    return INVALID;
-  }
-
-  typedef uint32_t elt_t;
-  static const unsigned int MAX_G = 65536 - 1; /* XXX Fix this... */
-  static const unsigned int SHIFT = 5;
-  static const unsigned int BITS = (1 << SHIFT);
-  static const unsigned int MASK = BITS - 1;
-  static const unsigned int ELTS = (MAX_G + 1 + (BITS - 1)) / BITS;
-  static  const hb_codepoint_t INVALID = HB_SET_VALUE_INVALID;
+    return find_backward (INVALID - 1, inverted);
+  }
 
-  elt_t &elt (hb_codepoint_t g) { return elts[g >> SHIFT]; }
-  elt_t const &elt (hb_codepoint_t g) const { return elts[g >> SHIFT]; }
-  elt_t mask (hb_codepoint_t g) const { return elt_t (1) << (g & MASK); }
+  static  const hb_codepoint_t INVALID = HB_SET_VALUE_INVALID;
 
-  elt_t elts[ELTS]; /* XXX 8kb */
+  private:
 
-  ASSERT_STATIC (sizeof (elt_t) * 8 == BITS);
-  ASSERT_STATIC (sizeof (elt_t) * 8 * ELTS > MAX_G);
-};
+  static inline unsigned int get_major (hb_codepoint_t g) { return g / page_t::PAGE_BITS; }
+  static inline hb_codepoint_t major_start (unsigned int major) { return major * page_t::PAGE_BITS; }
 
-struct hb_frozen_set_t
-{
-  static const unsigned int SHIFT = hb_set_t::SHIFT;
-  static const unsigned int BITS = hb_set_t::BITS;
-  static const unsigned int MASK = hb_set_t::MASK;
-  typedef hb_set_t::elt_t elt_t;
+  inline page_t &page_at (unsigned int i) { return pages[page_map[i].index]; }
+  inline const page_t &page_at (unsigned int i) const { return pages[page_map[i].index]; }
 
-  inline void init (const hb_set_t &set)
+  /* Returns the index of the first page_map entry whose major is not
+   * less than major; sets *found if it is equal. */
+  inline unsigned int bsearch_major (unsigned int major, bool *found) const
   {
-    start = count = 0;
-    elts = NULL;
-
-    unsigned int max = set.get_max ();
-    if (max == set.INVALID)
-      return;
-    unsigned int min = set.get_min ();
-    const elt_t &min_elt = set.elt (min);
-
-    start = min & ~MASK;
-    count = max - start + 1;
-    unsigned int num_elts = (count + BITS - 1) / BITS;
-    unsigned int elts_size = num_elts * sizeof (elt_t);
-    elts = (elt_t *) malloc (elts_size);
-    if (unlikely (!elts))
+    int min = 0, max = (int) page_map.len - 1;
+    while (min <= max)
     {
-      start = count = 0;
-      return;
+      int mid = (min + max) / 2;
+      unsigned int m = page_map[mid].major;
+      if (major < m)
+	max = mid - 1;
+      else if (major > m)
+	min = mid + 1;
+      else
+      {
+	*found = true;
+	return mid;
+      }
     }
-    memcpy (elts, &min_elt, elts_size);
+    *found = false;
+    return min;
   }
 
-  inline void fini (void)
+  inline const page_t *page_for (hb_codepoint_t g) const
   {
-    if (elts)
-      free (elts);
+    bool found;
+    unsigned int i = bsearch_major (get_major (g), &found);
+    return found ? &page_at (i) : NULL;
+  }
+  inline page_t *page_for (hb_codepoint_t g)
+  {
+    bool found;
+    unsigned int i = bsearch_major (get_major (g), &found);
+    return found ? &page_at (i) : NULL;
+  }
+  inline page_t *page_for_insert (hb_codepoint_t g)
+  {
+    bool found;
+    unsigned int major = get_major (g);
+    unsigned int i = bsearch_major (major, &found);
+    if (found)
+      return &page_at (i);
+
+    unsigned int count = pages.len;
+    if (unlikely (!resize (count + 1)))
+      return NULL;
+    pages[count].init0 ();
+    memmove (&page_map[i + 1], &page_map[i], (count - i) * sizeof (page_map[0]));
+    page_map[i].major = major;
+    page_map[i].index = count;
+    return &pages[count];
+  }
+
+  inline bool resize (unsigned int count)
+  {
+    if (unlikely (in_error)) return false;
+    while (pages.len < count)
+      if (unlikely (!pages.push ()))
+      {
+	in_error = true;
+	return false;
+      }
+    while (page_map.len < count)
+      if (unlikely (!page_map.push ()))
+      {
+	in_error = true;
+	return false;
+      }
+    pages.shrink (count);
+    page_map.shrink (count);
+    return true;
   }
 
-  inline bool has (hb_codepoint_t g) const
+  inline void del_raw (hb_codepoint_t g)
+  {
+    page_t *page = page_for (g);
+    if (page)
+      page->del (g);
+  }
+  inline void del_range_raw (hb_codepoint_t a, hb_codepoint_t b)
   {
-    /* hb_codepoint_t is unsigned. */
-    g -= start;
-    if (unlikely (g > count)) return false;
-    return !!(elt (g) & mask (g));
+    unsigned int ma = get_major (a);
+    unsigned int mb = get_major (b);
+    bool found;
+    for (unsigned int i = bsearch_major (ma, &found); i < page_map.len; i++)
+    {
+      unsigned int m = page_map[i].major;
+      if (m > mb)
+	break;
+      page_at (i).del_range (m == ma ? a : major_start (m),
+			     m == mb ? b : major_start (m + 1) - 1);
+    }
   }
 
-  elt_t const &elt (hb_codepoint_t g) const { return elts[g >> SHIFT]; }
-  elt_t mask (hb_codepoint_t g) const { return elt_t (1) << (g & MASK); }
+  template <typename Op>
+  inline void process (const hb_set_t *other)
+  {
+    if (Op::passthru_right)
+      for (unsigned int i = 0; i < other->page_map.len; i++)
+	if (!other->page_at (i).is_empty () &&
+	    unlikely (!page_for_insert (major_start (other->page_map[i].major))))
+	  return;
+
+    unsigned int count = page_map.len;
+    unsigned int other_count = other->page_map.len;
+    for (unsigned int a = 0, b = 0; a < count; a++)
+    {
+      unsigned int major = page_map[a].major;
+      while (b < other_count && other->page_map[b].major < major)
+	b++;
+      page_t &page = page_at (a);
+      if (b < other_count && other->page_map[b].major == major)
+      {
+	const page_t &other_page = other->page_at (b);
+	for (unsigned int j = 0; j < page_t::LEN; j++)
+	  page.v[j] = Op::op (page.v[j], other_page.v[j]);
+      }
+      else if (!Op::passthru_left)
+	page.init0 ();
+      /* Otherwise op (a, 0) == a. */
+    }
+  }
 
-  private:
-  hb_codepoint_t start, count;
-  elt_t *elts;
+  /* Returns the first number at or after start that is in the pages,
+   * or not if invert is true; or INVALID if there is none. */
+  inline hb_codepoint_t find (hb_codepoint_t start, bool invert) const
+  {
+    if (unlikely (start == INVALID))
+      return INVALID;
+    bool found;
+    unsigned int i = bsearch_major (get_major (start), &found);
+    if (!invert)
+    {
+      for (; i < page_map.len; i++)
+      {
+	hb_codepoint_t base = major_start (page_map[i].major);
+	unsigned int j = page_at (i).find (start > base ? start - base : 0, false);
+	if (j < page_t::PAGE_BITS)
+	  return base + j;
+      }
+      return INVALID;
+    }
+    else
+    {
+      /* Walk consecutive pages until one is missing or has a hole. */
+      for (;; i++)
+      {
+	if (i == page_map.len || page_map[i].major != get_major (start))
+	  return start;
+	hb_codepoint_t base = major_start (page_map[i].major);
+	unsigned int j = page_at (i).find (start - base, true);
+	if (j < page_t::PAGE_BITS)
+	  return base + j;
+	start = base + page_t::PAGE_BITS;
+	if (unlikely (!start)) /* Wrapped around. */
+	  return INVALID;
+      }
+    }
+  }
+  /* Same, going backwards from start. */
+  inline hb_codepoint_t find_backward (hb_codepoint_t start, bool invert) const
+  {
+    bool found;
+    int i = (int) bsearch_major (get_major (start), &found);
+    if (!found)
+    {
+      if (invert)
+	return start;
+      i--;
+    }
+    if (!invert)
+    {
+      for (; i >= 0; i--)
+      {
+	hb_codepoint_t base = major_start (page_map[i].major);
+	unsigned int j = page_at (i).find_backward (start - base < page_t::PAGE_BITS ? start - base : page_t::PAGE_MASK, false);
+	if (j != (unsigned int) -1)
+	  return base + j;
+      }
+      return INVALID;
+    }
+    else
+    {
+      for (;; i--)
+      {
+	if (i < 0 || page_map[i].major != get_major (start))
+	  return start;
+	hb_codepoint_t base = major_start (page_map[i].major);
+	unsigned int j = page_at (i).find_backward (start - base, true);
+	if (j != (unsigned int) -1)
+	  return base + j;
+	if (unlikely (!base))
+	  return INVALID;
+	start = base - 1;
+      }
+    }
+  }
 };
 
 
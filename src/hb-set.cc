@@ -62,9 +62,11 @@ hb_set_get_empty (void)
 {
   static const hb_set_t _hb_set_nil = {
     HB_OBJECT_HEADER_STATIC,
-    true, /* in_error */
+    true,  /* in_error */
+    false, /* inverted */
 
-    {0} /* elts */
+    HB_PREALLOCED_ARRAY_INIT, /* page_map */
+    HB_PREALLOCED_ARRAY_INIT  /* pages */
   };
 
   return const_cast<hb_set_t *> (&_hb_set_nil);
@@ -50,6 +50,14 @@ struct hb_shape_plan_t
   struct hb_shaper_data_t shaper_data;
 };
 
+/* Whether @feature applies to the whole buffer.  Plans only depend on this,
+ * not on the actual range, of each user feature. */
+static inline bool
+hb_feature_is_global (const hb_feature_t *feature)
+{
+  return feature->start == 0 && feature->end == (unsigned int) -1;
+}
+
 #define HB_SHAPER_DATA_CREATE_FUNC_EXTRA_ARGS \
 	, const hb_feature_t            *user_features \
 	, unsigned int                   num_user_features
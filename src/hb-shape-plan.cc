@@ -325,19 +325,11 @@ hb_shape_plan_execute (hb_shape_plan_t    *shape_plan,
  * caching
  */
 
-#if 0
-static unsigned int
-hb_shape_plan_hash (const hb_shape_plan_t *shape_plan)
-{
-  return hb_segment_properties_hash (&shape_plan->props) +
-	 shape_plan->default_shaper_list ? 0 : (intptr_t) shape_plan->shaper_func;
-}
-#endif
-
-/* User-feature caching is currently somewhat dumb:
- * it only finds matches where the feature array is identical,
- * not cases where the feature lists would be compatible for plan purposes
- * but have different ranges, for example.
+/* User-feature ranges only affect which glyphs get a feature's mask bits,
+ * which is done at execution time from the features passed to
+ * hb_shape_plan_execute().  The plan itself only depends on each feature's
+ * tag, value, and whether it is global.  As such, plans are matched on
+ * those, and one cached plan serves any range layout of the same features.
  */
 struct hb_shape_plan_proposal_t
 {
@@ -346,8 +338,29 @@ struct hb_shape_plan_proposal_t
   const hb_feature_t            *user_features;
   unsigned int                   num_user_features;
   hb_shape_func_t               *shaper_func;
+  unsigned int                   hash;
 };
 
+/* The shaper is not part of the hash, since a proposal with an explicit
+ * shaper list may be fulfilled by a plan made with the default list. */
+static unsigned int
+hb_shape_plan_proposal_hash (const hb_shape_plan_proposal_t *proposal)
+{
+  unsigned int h = hb_segment_properties_hash (&proposal->props);
+  for (unsigned int i = 0; i < proposal->num_user_features; i++)
+  {
+    const hb_feature_t &feature = proposal->user_features[i];
+    h = h * 31 + feature.tag;
+    h = h * 31 + feature.value;
+    h = h * 31 + hb_feature_is_global (&feature);
+  }
+  /* Mix the high bits down, since the bucket is picked by the low bits. */
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  return h;
+}
+
 static inline hb_bool_t
 hb_shape_plan_user_features_match (const hb_shape_plan_t          *shape_plan,
 				   const hb_shape_plan_proposal_t *proposal)
@@ -356,8 +369,8 @@ hb_shape_plan_user_features_match (const hb_shape_plan_t          *shape_plan,
   for (unsigned int i = 0, n = proposal->num_user_features; i < n; i++)
     if (proposal->user_features[i].tag   != shape_plan->user_features[i].tag   ||
         proposal->user_features[i].value != shape_plan->user_features[i].value ||
-        proposal->user_features[i].start != shape_plan->user_features[i].start ||
-        proposal->user_features[i].end   != shape_plan->user_features[i].end) return false;
+        hb_feature_is_global (&proposal->user_features[i]) !=
+	hb_feature_is_global (&shape_plan->user_features[i])) return false;
   return true;
 }
 
@@ -371,18 +384,6 @@ hb_shape_plan_matches (const hb_shape_plan_t          *shape_plan,
 	  (shape_plan->shaper_func == proposal->shaper_func));
 }
 
-static inline hb_bool_t
-hb_non_global_user_features_present (const hb_feature_t *user_features,
-				     unsigned int        num_user_features)
-{
-  while (num_user_features)
-    if (user_features->start != 0 || user_features->end != (unsigned int) -1)
-      return true;
-    else
-      num_user_features--, user_features++;
-  return false;
-}
-
 /**
  * hb_shape_plan_create_cached:
  * @face: 
@@ -415,7 +416,8 @@ hb_shape_plan_create_cached (hb_face_t                     *face,
     shaper_list,
     user_features,
     num_user_features,
-    NULL
+    NULL,
+    0
   };
 
   if (shaper_list) {
@@ -439,40 +441,73 @@ hb_shape_plan_create_cached (hb_face_t                     *face,
   }
 
 
+  proposal.hash = hb_shape_plan_proposal_hash (&proposal);
+  unsigned int bucket = proposal.hash % HB_SHAPE_PLAN_CACHE_BUCKETS;
+
+  hb_face_t::plan_node_t **buckets = (hb_face_t::plan_node_t **) hb_atomic_ptr_get (&face->shape_plans);
+
+  hb_shape_plan_t *shape_plan = NULL;
+
 retry:
-  hb_face_t::plan_node_t *cached_plan_nodes = (hb_face_t::plan_node_t *) hb_atomic_ptr_get (&face->shape_plans);
+  hb_face_t::plan_node_t *cached_plan_nodes = buckets ? (hb_face_t::plan_node_t *) hb_atomic_ptr_get (&buckets[bucket]) : NULL;
   for (hb_face_t::plan_node_t *node = cached_plan_nodes; node; node = node->next)
-    if (hb_shape_plan_matches (node->shape_plan, &proposal))
+    if (node->hash == proposal.hash &&
+	hb_shape_plan_matches (node->shape_plan, &proposal))
     {
       DEBUG_MSG_FUNC (SHAPE_PLAN, node->shape_plan, "fulfilled from cache");
+      if (unlikely (shape_plan)) /* Lost an insertion race to an identical plan. */
+	hb_shape_plan_destroy (shape_plan);
+      else
+	face->shape_plans_stats.hits.inc ();
       return hb_shape_plan_reference (node->shape_plan);
     }
 
-  /* Not found. */
+  if (!shape_plan)
+  {
+    /* Not found. */
 
-  hb_shape_plan_t *shape_plan = hb_shape_plan_create (face, props, user_features, num_user_features, shaper_list);
+    shape_plan = hb_shape_plan_create (face, props, user_features, num_user_features, shaper_list);
 
-  /* Don't add to the cache if face is inert. */
-  if (unlikely (hb_object_is_inert (face)))
-    return shape_plan;
+    /* Don't add to the cache if face is inert. */
+    if (unlikely (hb_object_is_inert (face)))
+      return shape_plan;
 
-  /* Don't add the plan to the cache if there were user features with non-global ranges */
+    face->shape_plans_stats.misses.inc ();
 
-  if (hb_non_global_user_features_present (user_features, num_user_features))
-    return shape_plan;
+    if (face->shape_plans_max &&
+	(unsigned int) face->shape_plans_stats.count.get_unsafe () >= face->shape_plans_max)
+    {
+      face->shape_plans_stats.dropped.inc ();
+      return shape_plan;
+    }
+  }
+
+  if (unlikely (!buckets))
+  {
+    buckets = (hb_face_t::plan_node_t **) calloc (HB_SHAPE_PLAN_CACHE_BUCKETS, sizeof (hb_face_t::plan_node_t *));
+    if (unlikely (!buckets))
+      return shape_plan;
+
+    if (!hb_atomic_ptr_cmpexch (&face->shape_plans, NULL, buckets))
+    {
+      free (buckets);
+      buckets = (hb_face_t::plan_node_t **) hb_atomic_ptr_get (&face->shape_plans);
+    }
+  }
 
   hb_face_t::plan_node_t *node = (hb_face_t::plan_node_t *) calloc (1, sizeof (hb_face_t::plan_node_t));
   if (unlikely (!node))
     return shape_plan;
 
   node->shape_plan = shape_plan;
+  node->hash = proposal.hash;
   node->next = cached_plan_nodes;
 
-  if (!hb_atomic_ptr_cmpexch (&face->shape_plans, cached_plan_nodes, node)) {
-    hb_shape_plan_destroy (shape_plan);
+  if (!hb_atomic_ptr_cmpexch (&buckets[bucket], cached_plan_nodes, node)) {
     free (node);
     goto retry;
   }
+  face->shape_plans_stats.count.inc ();
   DEBUG_MSG_FUNC (SHAPE_PLAN, shape_plan, "inserted into cache");
 
   return hb_shape_plan_reference (shape_plan);
@@ -409,3 +409,87 @@ hb_shape (hb_font_t           *font,
 {
   hb_shape_full (font, buffer, features, num_features, NULL);
 }
+
+/**
+ * hb_shape_codepoints:
+ * @font: an #hb_font_t to use for shaping
+ * @buffer: an #hb_buffer_t to shape in
+ * @features: (array length=num_features) (allow-none): an array of user
+ *    specified #hb_feature_t or %NULL
+ * @num_features: the length of @features array
+ * @text: (array length=text_length): an array of Unicode code points
+ * @text_length: the length of @text, or -1 if it is zero-terminated
+ * @item_offset: the offset of the first code point to shape
+ * @item_length: the number of code points to shape, or -1 for the rest
+ *    of @text
+ * @glyph_count: (inout) (allow-none): in: the length of the output arrays;
+ *    out: the number of glyphs written to them
+ * @glyphs: (out) (array length=glyph_count) (allow-none): glyph indices
+ * @clusters: (out) (array length=glyph_count) (allow-none): glyph clusters
+ * @positions: (out) (array length=glyph_count) (allow-none): glyph positions
+ *
+ * Shapes a run of code points straight from the caller's array into the
+ * caller's output arrays, without going through hb_buffer_add_codepoints()
+ * and hb_buffer_get_glyph_infos().  The text around the item is used as
+ * context.  Clusters are offsets into @text.
+ *
+ * @buffer is only used as scratch space, and keeps the shaped glyphs
+ * afterwards: its previous contents are cleared, but its segment
+ * properties (guessed if unset), flags and Unicode functions are used.
+ * Give it storage with hb_buffer_set_storage() to shape without any
+ * allocation.  Any of the output arrays can be %NULL.
+ *
+ * Return value: the total number of glyphs, which may be more than were
+ *    written; 0 if all shapers failed.
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_shape_codepoints (hb_font_t            *font,
+		     hb_buffer_t          *buffer,
+		     const hb_feature_t   *features,
+		     unsigned int          num_features,
+		     const hb_codepoint_t *text,
+		     int                   text_length,
+		     unsigned int          item_offset,
+		     int                   item_length,
+		     unsigned int         *glyph_count, /* IN/OUT */
+		     hb_codepoint_t       *glyphs, /* OUT */
+		     uint32_t             *clusters, /* OUT */
+		     hb_glyph_position_t  *positions /* OUT */)
+{
+  if (unlikely (hb_object_is_inert (buffer)))
+  {
+    if (glyph_count)
+      *glyph_count = 0;
+    return 0;
+  }
+
+  hb_segment_properties_t props = buffer->props;
+  buffer->clear ();
+  buffer->props = props;
+
+  hb_buffer_add_codepoints (buffer, text, text_length, item_offset, item_length);
+  buffer->guess_segment_properties ();
+
+  unsigned int len = 0;
+  if (likely (hb_shape_full (font, buffer, features, num_features, NULL)))
+    len = buffer->len;
+
+  if (glyph_count)
+  {
+    unsigned int count = MIN (*glyph_count, len);
+    const hb_glyph_info_t *info = buffer->info;
+    if (glyphs)
+      for (unsigned int i = 0; i < count; i++)
+	glyphs[i] = info[i].codepoint;
+    if (clusters)
+      for (unsigned int i = 0; i < count; i++)
+	clusters[i] = info[i].cluster;
+    if (positions && count)
+      memcpy (positions, hb_buffer_get_glyph_positions (buffer, NULL), count * sizeof (positions[0]));
+    *glyph_count = count;
+  }
+
+  return len;
+}
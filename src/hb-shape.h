@@ -69,6 +69,20 @@ hb_shape_full (hb_font_t          *font,
 	       unsigned int        num_features,
 	       const char * const *shaper_list);
 
+unsigned int
+hb_shape_codepoints (hb_font_t            *font,
+		     hb_buffer_t          *buffer,
+		     const hb_feature_t   *features,
+		     unsigned int          num_features,
+		     const hb_codepoint_t *text,
+		     int                   text_length,
+		     unsigned int          item_offset,
+		     int                   item_length,
+		     unsigned int         *glyph_count, /* IN/OUT */
+		     hb_codepoint_t       *glyphs, /* OUT */
+		     uint32_t             *clusters, /* OUT */
+		     hb_glyph_position_t  *positions /* OUT */);
+
 const char **
 hb_shape_list_shapers (void);
 
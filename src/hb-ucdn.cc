@@ -210,6 +210,24 @@ hb_ucdn_decompose_compatibility(hb_unicode_funcs_t *ufuncs,
     return ucdn_compat_decompose(u, decomposed);
 }
 
+static void
+hb_ucdn_props(unsigned int count,
+	      const hb_codepoint_t *first_unicode,
+	      unsigned int unicode_stride,
+	      hb_unicode_props_t *props)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+	int category, combining, mirrored, script;
+	ucdn_get_properties(*first_unicode, &category, &combining, &mirrored, &script);
+	props[i].script = ucdn_script_translate[script];
+	props[i].general_category = category;
+	props[i].combining_class = combining;
+	props[i].mirrored = mirrored;
+	first_unicode = (const hb_codepoint_t *) (const void *) ((const char *) first_unicode + unicode_stride);
+    }
+}
+
 extern "C" HB_INTERNAL
 hb_unicode_funcs_t *
 hb_ucdn_get_unicode_funcs (void)
@@ -223,7 +241,18 @@ hb_ucdn_get_unicode_funcs (void)
 #define HB_UNICODE_FUNC_IMPLEMENT(name) hb_ucdn_##name,
       HB_UNICODE_FUNCS_IMPLEMENT_CALLBACKS
 #undef HB_UNICODE_FUNC_IMPLEMENT
-    }
+    },
+    {
+#define HB_UNICODE_FUNC_IMPLEMENT(name) NULL,
+      HB_UNICODE_FUNCS_IMPLEMENT_CALLBACKS
+#undef HB_UNICODE_FUNC_IMPLEMENT
+    },
+    {
+#define HB_UNICODE_FUNC_IMPLEMENT(name) NULL,
+      HB_UNICODE_FUNCS_IMPLEMENT_CALLBACKS
+#undef HB_UNICODE_FUNC_IMPLEMENT
+    },
+    hb_ucdn_props
   };
 
   return const_cast<hb_unicode_funcs_t *> (&_hb_ucdn_unicode_funcs);
@@ -199,6 +199,17 @@ int ucdn_get_script(uint32_t code)
     return get_ucd_record(code)->script;
 }
 
+void ucdn_get_properties(uint32_t code, int *category, int *combining,
+        int *mirrored, int *script)
+{
+    const UCDRecord *record = get_ucd_record(code);
+
+    *category = record->category;
+    *combining = record->combining;
+    *mirrored = record->mirrored;
+    *script = record->script;
+}
+
 uint32_t ucdn_mirror(uint32_t code)
 {
     MirrorPair mp = {0};
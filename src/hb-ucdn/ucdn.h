@@ -303,6 +303,19 @@ int ucdn_get_script(uint32_t code);
  */
 int ucdn_get_mirrored(uint32_t code);
 
+/**
+ * Get general category, canonical combining class, mirrored flag and
+ * script of a codepoint, with a single lookup.
+ *
+ * @param code Unicode codepoint
+ * @param category set as returned by ucdn_get_general_category()
+ * @param combining set as returned by ucdn_get_combining_class()
+ * @param mirrored set as returned by ucdn_get_mirrored()
+ * @param script set as returned by ucdn_get_script()
+ */
+void ucdn_get_properties(uint32_t code, int *category, int *combining,
+        int *mirrored, int *script);
+
 /**
  * Mirror a codepoint.
  *
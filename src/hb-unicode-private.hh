@@ -61,6 +61,21 @@ extern HB_INTERNAL const uint8_t _hb_modified_combining_class[256];
   HB_UNICODE_FUNC_IMPLEMENT (hb_script_t, script) \
   /* ^--- Add new simple callbacks here */
 
+/* The properties of a character that built-in implementations can
+ * look up at once, for many characters. */
+struct hb_unicode_props_t
+{
+  hb_script_t script;
+  uint8_t general_category; /* hb_unicode_general_category_t */
+  uint8_t combining_class; /* hb_unicode_combining_class_t */
+  bool mirrored;
+};
+
+typedef void (*hb_unicode_props_func_t) (unsigned int count,
+					 const hb_codepoint_t *first_unicode,
+					 unsigned int unicode_stride,
+					 hb_unicode_props_t *props);
+
 struct hb_unicode_funcs_t {
   hb_object_header_t header;
   ASSERT_POD ();
@@ -119,6 +134,17 @@ HB_UNICODE_FUNCS_IMPLEMENT_CALLBACKS_SIMPLE
     return _hb_modified_combining_class[combining_class (unicode)];
   }
 
+  /* Same as above, given the combining class of unicode. */
+  inline unsigned int
+  modified_combining_class (hb_codepoint_t unicode, unsigned int combining_class)
+  {
+    /* The hacks above. */
+    if (unlikely (unicode == 0x0FC6u || unicode == 0x1037u || unicode == 0x1A60u))
+      return modified_combining_class (unicode);
+
+    return _hb_modified_combining_class[combining_class];
+  }
+
   static inline hb_bool_t
   is_variation_selector (hb_codepoint_t unicode)
   {
@@ -217,6 +243,11 @@ HB_UNICODE_FUNCS_IMPLEMENT_CALLBACKS_SIMPLE
     HB_UNICODE_FUNCS_IMPLEMENT_CALLBACKS
 #undef HB_UNICODE_FUNC_IMPLEMENT
   } destroy;
+
+  /* Set by built-in implementations only, that can look up the
+   * properties of many characters without going through the callbacks
+   * above; NULL otherwise.  Not inherited by hb_unicode_funcs_create(). */
+  hb_unicode_props_func_t props;
 };
 
 
@@ -31,6 +31,7 @@
 #include "hb-private.hh"
 
 #include "hb-unicode-private.hh"
+#include "hb-utf-private.hh"
 
 
 
@@ -454,6 +455,297 @@ hb_unicode_decompose_compatibility (hb_unicode_funcs_t *ufuncs,
 }
 
 
+/*
+ * Script itemization
+ */
+
+/* Splits text into runs of a single script, following UAX #24:
+ * Common and Inherited characters join the surrounding run, and a
+ * closing bracket gets the script of its matching opening bracket.
+ * Brackets are paired using the mirroring and general-category
+ * callbacks, ie. an Open_Punctuation character with a mirror opens
+ * a pair that its mirror closes. */
+struct hb_unicode_script_itemizer_t
+{
+  enum { MAX_DEPTH = 64 };
+
+  inline hb_unicode_script_itemizer_t (hb_unicode_funcs_t *ufuncs_,
+				       unsigned int start_offset_,
+				       unsigned int *run_count,
+				       hb_unicode_script_run_t *runs_) :
+    ufuncs (ufuncs_),
+    runs (runs_),
+    start_offset (start_offset_),
+    max_runs (run_count ? *run_count : 0),
+    num_runs (0),
+    run_start (0),
+    run_script (HB_SCRIPT_COMMON),
+    depth (0) {}
+
+  /* general_category is only consulted for characters whose script is
+   * not a real one; mirrored is a hint that may be true spuriously. */
+  inline void add (unsigned int offset,
+		   hb_codepoint_t u,
+		   hb_script_t script,
+		   hb_unicode_general_category_t general_category,
+		   bool mirrored)
+  {
+    if (script == HB_SCRIPT_COMMON ||
+	script == HB_SCRIPT_INHERITED ||
+	script == HB_SCRIPT_UNKNOWN)
+    {
+      if (general_category == HB_UNICODE_GENERAL_CATEGORY_OPEN_PUNCTUATION)
+      {
+	hb_codepoint_t mirror;
+	if (mirrored && (mirror = ufuncs->mirroring (u)) != u)
+	  push (mirror);
+	return;
+      }
+      if (general_category != HB_UNICODE_GENERAL_CATEGORY_CLOSE_PUNCTUATION)
+	return;
+
+      script = pop (u);
+      if (script == HB_SCRIPT_COMMON)
+	return;
+    }
+
+    if (likely (script == run_script))
+      return;
+
+    if (run_script == HB_SCRIPT_COMMON)
+    {
+      /* Leading Common text, and brackets opened in it, take the
+       * first real script that follows. */
+      run_script = script;
+      for (unsigned int i = 0; i < depth; i++)
+	if (stack[i].script == HB_SCRIPT_COMMON)
+	  stack[i].script = script;
+      return;
+    }
+
+    end_run (offset);
+    run_script = script;
+  }
+
+  inline void end_run (unsigned int offset)
+  {
+    if (offset == run_start)
+      return;
+
+    if (num_runs >= start_offset && num_runs - start_offset < max_runs)
+    {
+      hb_unicode_script_run_t *run = &runs[num_runs - start_offset];
+      run->start = run_start;
+      run->length = offset - run_start;
+      run->script = run_script;
+      run->direction = hb_script_get_horizontal_direction (run_script);
+      if (unlikely (run->direction == HB_DIRECTION_INVALID))
+	run->direction = HB_DIRECTION_LTR;
+    }
+    num_runs++;
+    run_start = offset;
+  }
+
+  /* Returns the total number of runs. */
+  inline unsigned int finish (unsigned int end, unsigned int *run_count)
+  {
+    end_run (end);
+    if (run_count)
+      *run_count = num_runs > start_offset ? MIN (num_runs - start_offset, max_runs) : 0;
+    return num_runs;
+  }
+
+  private:
+
+  inline void push (hb_codepoint_t close)
+  {
+    if (unlikely (depth == MAX_DEPTH))
+    {
+      /* Forget the outermost bracket. */
+      memmove (stack, stack + 1, (MAX_DEPTH - 1) * sizeof (stack[0]));
+      depth--;
+    }
+    stack[depth].close = close;
+    stack[depth].script = run_script;
+    depth++;
+  }
+
+  /* Returns the script of the bracket u closes, or Common if none. */
+  inline hb_script_t pop (hb_codepoint_t u)
+  {
+    for (unsigned int i = depth; i; i--)
+      if (stack[i - 1].close == u)
+      {
+	depth = i - 1;
+	return stack[i - 1].script;
+      }
+    return HB_SCRIPT_COMMON;
+  }
+
+  hb_unicode_funcs_t *ufuncs;
+  hb_unicode_script_run_t *runs;
+  unsigned int start_offset;
+  unsigned int max_runs;
+  unsigned int num_runs;
+
+  unsigned int run_start;
+  hb_script_t run_script;
+
+  struct bracket_t {
+    hb_codepoint_t close;
+    hb_script_t script;
+  } stack[MAX_DEPTH];
+  unsigned int depth;
+};
+
+template <typename utf_t>
+static unsigned int
+hb_unicode_script_itemize (hb_unicode_funcs_t *ufuncs,
+			   const typename utf_t::codepoint_t *text,
+			   int text_length,
+			   unsigned int start_offset,
+			   unsigned int *run_count,
+			   hb_unicode_script_run_t *runs)
+{
+  typedef typename utf_t::codepoint_t T;
+
+  if (text_length == -1)
+    text_length = utf_t::strlen (text);
+
+  hb_unicode_script_itemizer_t itemizer (ufuncs, start_offset, run_count, runs);
+
+  /* Decode in chunks, so that built-in functions can look up the
+   * properties of a whole chunk at once. */
+  const T *next = text;
+  const T *end = text + text_length;
+  while (next < end)
+  {
+    hb_codepoint_t u[64];
+    unsigned int offsets[64];
+    unsigned int count = 0;
+    do {
+      offsets[count] = next - text;
+      next = utf_t::next (next, end, &u[count], 0xFFFDu);
+      count++;
+    } while (count < ARRAY_LENGTH (u) && next < end);
+
+    if (ufuncs->props)
+    {
+      hb_unicode_props_t props[ARRAY_LENGTH (u)];
+      ufuncs->props (count, u, sizeof (u[0]), props);
+      for (unsigned int i = 0; i < count; i++)
+	itemizer.add (offsets[i], u[i],
+		      props[i].script,
+		      (hb_unicode_general_category_t) props[i].general_category,
+		      props[i].mirrored);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < count; i++)
+      {
+	hb_script_t script = ufuncs->script (u[i]);
+	hb_unicode_general_category_t gen_cat = HB_UNICODE_GENERAL_CATEGORY_OTHER_LETTER;
+	if (script == HB_SCRIPT_COMMON ||
+	    script == HB_SCRIPT_INHERITED ||
+	    script == HB_SCRIPT_UNKNOWN)
+	  gen_cat = ufuncs->general_category (u[i]);
+	itemizer.add (offsets[i], u[i], script, gen_cat, true);
+      }
+    }
+  }
+
+  return itemizer.finish (text_length, run_count);
+}
+
+/**
+ * hb_unicode_script_itemize_utf8:
+ * @ufuncs: Unicode functions to get character scripts from.
+ * @text: (array length=text_length): UTF-8 text to itemize.
+ * @text_length: length of @text in bytes, or -1 if it is %NULL-terminated.
+ * @start_offset: index of the first run to return.
+ * @run_count: (inout) (allow-none): in: size of @runs; out: number of runs
+ * returned.
+ * @runs: (out caller-allocates) (array length=run_count): runs of @text.
+ *
+ * Splits @text into runs of a single script each, ready to be added to
+ * a buffer and shaped.  Characters of the Common and Inherited scripts
+ * join the run they are in, and paired brackets get the same script.
+ * A @runs array with as many entries as @text has characters never
+ * truncates the result.
+ *
+ * Return value: total number of runs in @text.
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_unicode_script_itemize_utf8 (hb_unicode_funcs_t      *ufuncs,
+				const char              *text,
+				int                      text_length,
+				unsigned int             start_offset,
+				unsigned int            *run_count /* IN/OUT */,
+				hb_unicode_script_run_t *runs /* OUT */)
+{
+  return hb_unicode_script_itemize<hb_utf8_t> (ufuncs, (const uint8_t *) text, text_length,
+					       start_offset, run_count, runs);
+}
+
+/**
+ * hb_unicode_script_itemize_utf16:
+ * @ufuncs: Unicode functions to get character scripts from.
+ * @text: (array length=text_length): UTF-16 text to itemize.
+ * @text_length: length of @text in code units, or -1 if it is %NULL-terminated.
+ * @start_offset: index of the first run to return.
+ * @run_count: (inout) (allow-none): in: size of @runs; out: number of runs
+ * returned.
+ * @runs: (out caller-allocates) (array length=run_count): runs of @text.
+ *
+ * See hb_unicode_script_itemize_utf8().
+ *
+ * Return value: total number of runs in @text.
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_unicode_script_itemize_utf16 (hb_unicode_funcs_t      *ufuncs,
+				 const uint16_t          *text,
+				 int                      text_length,
+				 unsigned int             start_offset,
+				 unsigned int            *run_count /* IN/OUT */,
+				 hb_unicode_script_run_t *runs /* OUT */)
+{
+  return hb_unicode_script_itemize<hb_utf16_t> (ufuncs, text, text_length,
+						start_offset, run_count, runs);
+}
+
+/**
+ * hb_unicode_script_itemize_utf32:
+ * @ufuncs: Unicode functions to get character scripts from.
+ * @text: (array length=text_length): UTF-32 text to itemize.
+ * @text_length: length of @text in code units, or -1 if it is %NULL-terminated.
+ * @start_offset: index of the first run to return.
+ * @run_count: (inout) (allow-none): in: size of @runs; out: number of runs
+ * returned.
+ * @runs: (out caller-allocates) (array length=run_count): runs of @text.
+ *
+ * See hb_unicode_script_itemize_utf8().
+ *
+ * Return value: total number of runs in @text.
+ *
+ * Since: 0.9.41
+ **/
+unsigned int
+hb_unicode_script_itemize_utf32 (hb_unicode_funcs_t      *ufuncs,
+				 const uint32_t          *text,
+				 int                      text_length,
+				 unsigned int             start_offset,
+				 unsigned int            *run_count /* IN/OUT */,
+				 hb_unicode_script_run_t *runs /* OUT */)
+{
+  return hb_unicode_script_itemize<hb_utf32_t<> > (ufuncs, text, text_length,
+						   start_offset, run_count, runs);
+}
+
+
 /* See hb-unicode-private.hh for details. */
 const uint8_t
 _hb_modified_combining_class[256] =
@@ -465,6 +465,56 @@ hb_unicode_decompose_compatibility (hb_unicode_funcs_t *ufuncs,
 				    hb_codepoint_t      u,
 				    hb_codepoint_t     *decomposed);
 
+/* itemization */
+
+/**
+ * hb_unicode_script_run_t:
+ * @start: offset of the first code unit of the run in the text.
+ * @length: number of code units in the run.
+ * @script: resolved script of the run.
+ * @direction: horizontal direction of @script.
+ *
+ * A run of text that can be shaped with a single script and direction.
+ * @start and @length are in code units of the itemized text and can be
+ * passed as item offset and length to hb_buffer_add_utf8() and friends.
+ *
+ * Since: 0.9.41
+ */
+typedef struct hb_unicode_script_run_t {
+  unsigned int   start;
+  unsigned int   length;
+  hb_script_t    script;
+  hb_direction_t direction;
+
+  /*< private >*/
+  void *reserved1;
+  void *reserved2;
+} hb_unicode_script_run_t;
+
+unsigned int
+hb_unicode_script_itemize_utf8 (hb_unicode_funcs_t      *ufuncs,
+				const char              *text,
+				int                      text_length,
+				unsigned int             start_offset,
+				unsigned int            *run_count /* IN/OUT */,
+				hb_unicode_script_run_t *runs /* OUT */);
+
+unsigned int
+hb_unicode_script_itemize_utf16 (hb_unicode_funcs_t      *ufuncs,
+				 const uint16_t          *text,
+				 int                      text_length,
+				 unsigned int             start_offset,
+				 unsigned int            *run_count /* IN/OUT */,
+				 hb_unicode_script_run_t *runs /* OUT */);
+
+unsigned int
+hb_unicode_script_itemize_utf32 (hb_unicode_funcs_t      *ufuncs,
+				 const uint32_t          *text,
+				 int                      text_length,
+				 unsigned int             start_offset,
+				 unsigned int            *run_count /* IN/OUT */,
+				 hb_unicode_script_run_t *runs /* OUT */);
+
 HB_END_DECLS
 
 #endif /* HB_UNICODE_H */
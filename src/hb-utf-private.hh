@@ -120,6 +120,28 @@ struct hb_utf8_t
     return end - 1;
   }
 
+  /* Returns the end of the run of ASCII starting at text, which decodes
+   * to one character per byte.  Checks eight bytes at a time. */
+  static inline const uint8_t *
+  skip_trivial (const uint8_t *text,
+		const uint8_t *end)
+  {
+    const uint64_t high_bits = ((uint64_t) 0x80808080u << 32) | 0x80808080u;
+    if (text < end && *text > 0x7Fu)
+      return text;
+    while (end - text >= 8)
+    {
+      uint64_t v;
+      memcpy (&v, text, 8);
+      if (v & high_bits)
+	break;
+      text += 8;
+    }
+    while (text < end && *text <= 0x7Fu)
+      text++;
+    return text;
+  }
+
   static inline unsigned int
   strlen (const uint8_t *text)
   {
@@ -190,6 +212,17 @@ struct hb_utf16_t
   }
 
 
+  /* Returns the end of the run of non-surrogates starting at text, which
+   * decodes to one character per code unit. */
+  static inline const uint16_t *
+  skip_trivial (const uint16_t *text,
+		const uint16_t *end)
+  {
+    while (text < end && !hb_in_range<hb_codepoint_t> (*text, 0xD800u, 0xDFFFu))
+      text++;
+    return text;
+  }
+
   static inline unsigned int
   strlen (const uint16_t *text)
   {
@@ -232,6 +265,18 @@ struct hb_utf32_t
     return text - 1;
   }
 
+  /* Returns the end of the run of valid characters starting at text. */
+  static inline const uint32_t *
+  skip_trivial (const uint32_t *text,
+		const uint32_t *end)
+  {
+    if (!validate)
+      return end;
+    while (text < end && *text <= 0x10FFFFu && !hb_in_range (*text, 0xD800u, 0xDFFFu))
+      text++;
+    return text;
+  }
+
   static inline unsigned int
   strlen (const uint32_t *text)
   {
@@ -266,6 +311,13 @@ struct hb_latin1_t
     return text;
   }
 
+  static inline const uint8_t *
+  skip_trivial (const uint8_t *text HB_UNUSED,
+		const uint8_t *end)
+  {
+    return end;
+  }
+
   static inline unsigned int
   strlen (const uint8_t *text)
   {
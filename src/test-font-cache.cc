@@ -0,0 +1,197 @@
+/*
+ * Copyright © 2026  agent
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ * Author(s): agent
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "hb.h"
+#include "hb-ot.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef HAVE_FREETYPE
+#include "hb-ft.h"
+#endif
+
+/* Shapes long Latin and CJK runs with and without the per-font
+ * glyph / advance cache and reports how many font-function calls
+ * the cache saved. */
+
+static unsigned int glyph_calls;
+static unsigned int advance_calls;
+
+static hb_bool_t
+counting_glyph_func (hb_font_t *font, void *font_data,
+		     hb_codepoint_t unicode, hb_codepoint_t variation_selector,
+		     hb_codepoint_t *glyph,
+		     void *user_data)
+{
+  glyph_calls++;
+  return hb_font_get_glyph (hb_font_get_parent (font), unicode, variation_selector, glyph);
+}
+
+static hb_position_t
+counting_h_advance_func (hb_font_t *font, void *font_data,
+			 hb_codepoint_t glyph,
+			 void *user_data)
+{
+  advance_calls++;
+  return hb_font_get_glyph_h_advance (hb_font_get_parent (font), glyph);
+}
+
+static hb_font_funcs_t *
+counting_funcs (void)
+{
+  hb_font_funcs_t *ffuncs = hb_font_funcs_create ();
+  hb_font_funcs_set_glyph_func (ffuncs, counting_glyph_func, NULL, NULL);
+  hb_font_funcs_set_glyph_h_advance_func (ffuncs, counting_h_advance_func, NULL, NULL);
+  hb_font_funcs_make_immutable (ffuncs);
+  return ffuncs;
+}
+
+static void
+fill_latin (hb_buffer_t *buffer, unsigned int len)
+{
+  static const char text[] = "The quick brown fox jumps over the lazy dog. "
+			     "Pack my box with five dozen liquor jugs! ";
+  hb_buffer_clear_contents (buffer);
+  for (unsigned int i = 0; i < len; i++)
+    hb_buffer_add (buffer, (unsigned char) text[i % (sizeof (text) - 1)], i);
+  hb_buffer_set_content_type (buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
+  hb_buffer_set_script (buffer, HB_SCRIPT_LATIN);
+  hb_buffer_set_direction (buffer, HB_DIRECTION_LTR);
+}
+
+static void
+fill_cjk (hb_buffer_t *buffer, unsigned int len)
+{
+  /* Skewed pseudo-random pick from the first 2048 URO ideographs;
+   * roughly mimics the character frequencies of running text. */
+  unsigned int seed = 1;
+  hb_buffer_clear_contents (buffer);
+  for (unsigned int i = 0; i < len; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    unsigned int r = (seed >> 16) & 0x7FF;
+    hb_buffer_add (buffer, 0x4E00 + ((r * r) >> 11), i);
+  }
+  hb_buffer_set_content_type (buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
+  hb_buffer_set_script (buffer, HB_SCRIPT_HAN);
+  hb_buffer_set_direction (buffer, HB_DIRECTION_LTR);
+}
+
+static void
+run (hb_face_t *face, const char *name,
+     void (*fill) (hb_buffer_t *, unsigned int),
+     unsigned int len, unsigned int iterations, bool cached)
+{
+  hb_font_t *parent = hb_font_create (face);
+  unsigned int upem = hb_face_get_upem (face);
+  hb_font_set_scale (parent, upem, upem);
+#ifdef HAVE_FREETYPE
+  hb_ft_font_set_funcs (parent);
+#endif
+  hb_font_t *font = hb_font_create_sub_font (parent);
+  hb_font_destroy (parent);
+  hb_font_funcs_t *ffuncs = counting_funcs ();
+  hb_font_set_funcs (font, ffuncs, NULL, NULL);
+  hb_font_funcs_destroy (ffuncs);
+  hb_font_set_cache_enabled (font, cached);
+
+  hb_buffer_t *buffer = hb_buffer_create ();
+  glyph_calls = advance_calls = 0;
+
+  clock_t start = clock ();
+  for (unsigned int i = 0; i < iterations; i++)
+  {
+    fill (buffer, len);
+    hb_shape (font, buffer, NULL, 0);
+  }
+  double ms = (clock () - start) * 1000. / CLOCKS_PER_SEC;
+
+  unsigned int glyph_hits, glyph_misses, advance_hits, advance_misses;
+  hb_font_get_cache_stats (font, &glyph_hits, &glyph_misses, &advance_hits, &advance_misses);
+
+  printf ("%-6s %-9s %9.2fms  glyph calls %9u (hits %9u)  advance calls %9u (hits %9u)\n",
+	  name, cached ? "cached" : "uncached", ms,
+	  glyph_calls, glyph_hits,
+	  advance_calls, advance_hits);
+
+  hb_buffer_destroy (buffer);
+  hb_font_destroy (font);
+}
+
+int
+main (int argc, char **argv)
+{
+  hb_blob_t *blob = NULL;
+
+  if (argc != 2 && argc != 3) {
+    fprintf (stderr, "usage: %s font-file [iterations]\n", argv[0]);
+    exit (1);
+  }
+
+  unsigned int iterations = argc > 2 ? strtol (argv[2], NULL, 0) : 100;
+
+  /* Create the blob */
+  {
+    const char *font_data;
+    unsigned int len;
+
+    FILE *f = fopen (argv[1], "rb");
+    if (!f) {
+      fprintf (stderr, "cannot open %s\n", argv[1]);
+      exit (1);
+    }
+    fseek (f, 0, SEEK_END);
+    len = ftell (f);
+    fseek (f, 0, SEEK_SET);
+    font_data = (const char *) malloc (len);
+    if (!font_data) len = 0;
+    len = fread ((char *) font_data, 1, len, f);
+    fclose (f);
+
+    blob = hb_blob_create (font_data, len, HB_MEMORY_MODE_WRITABLE, (void *) font_data, free);
+  }
+
+  /* Create the face */
+  hb_face_t *face = hb_face_create (blob, 0 /* first face */);
+  hb_blob_destroy (blob);
+  blob = NULL;
+
+  const unsigned int len = 4096;
+  for (unsigned int cached = 0; cached < 2; cached++)
+    run (face, "Latin", fill_latin, len, iterations, cached);
+  for (unsigned int cached = 0; cached < 2; cached++)
+    run (face, "CJK", fill_cjk, len, iterations, cached);
+
+  hb_face_destroy (face);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2026  agent
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ * Author(s): agent
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "hb.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Measures script itemization throughput on mixed-script text, with
+ * the default Unicode functions (which may look properties up in bulk)
+ * and with a subclass of them (which goes through the callbacks). */
+
+static const char *corpora[][2] = {
+  {"Latin+Greek", "The word \xCE\xBB\xCF\x8C\xCE\xB3\xCE\xBF\xCF\x82 (logos) means "
+		  "\"word\"; \xE1\xBC\x80\xCF\x81\xCF\x87\xE1\xBD\xB4 is \"beginning\". "},
+  {"Arabic+Latin", "\xD9\x82\xD8\xA7\xD9\x84 [HarfBuzz 1.0] \xD8\xA5\xD9\x86 "
+		   "\xD8\xA7\xD9\x84\xD9\x86\xD8\xB5 (text) \xD9\x85\xD9\x87\xD9\x85. "},
+  {"Han+Kana+Latin", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE"
+		     "\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88 (Unicode 7.0) "
+		     "\xE3\x81\xA8\xE4\xB8\xAD\xE6\x96\x87\xE3\x80\x82"},
+  {"Devanagari+Latin", "\xE0\xA4\xB9\xE0\xA4\xBF\xE0\xA4\x82\xE0\xA4\xA6\xE0\xA5\x80 "
+		       "\xE0\xA4\xAA\xE0\xA4\xBE\xE0\xA4\xA0 \"Hindi text\", 2015. "},
+};
+
+static void
+run (hb_unicode_funcs_t *ufuncs, const char *ufuncs_name,
+     const char *name, const char *text, unsigned int len,
+     unsigned int iterations)
+{
+  unsigned int runs = 0;
+
+  clock_t start = clock ();
+  for (unsigned int i = 0; i < iterations; i++)
+    runs += hb_unicode_script_itemize_utf8 (ufuncs, text, len, 0, NULL, NULL);
+  double ms = (clock () - start) * 1000. / CLOCKS_PER_SEC;
+
+  printf ("%-17s %-8s %9.2fms  %8.1fMB/s  %u runs\n",
+	  name, ufuncs_name, ms,
+	  ms ? len * (double) iterations / (ms * 1000.) : 0.,
+	  runs / iterations);
+}
+
+static void
+run_all (const char *name, const char *text, unsigned int len, unsigned int iterations)
+{
+  hb_unicode_funcs_t *ufuncs = hb_unicode_funcs_get_default ();
+  hb_unicode_funcs_t *child = hb_unicode_funcs_create (ufuncs);
+
+  run (ufuncs, "default", name, text, len, iterations);
+  run (child, "subclass", name, text, len, iterations);
+
+  hb_unicode_funcs_destroy (child);
+}
+
+int
+main (int argc, char **argv)
+{
+  if (argc > 3) {
+    fprintf (stderr, "usage: %s [text-file [iterations]]\n", argv[0]);
+    exit (1);
+  }
+
+  unsigned int iterations = argc > 2 ? strtol (argv[2], NULL, 0) : 100;
+
+  if (argc > 1)
+  {
+    FILE *f = fopen (argv[1], "rb");
+    if (!f) {
+      fprintf (stderr, "cannot open %s\n", argv[1]);
+      exit (1);
+    }
+    fseek (f, 0, SEEK_END);
+    unsigned int len = ftell (f);
+    fseek (f, 0, SEEK_SET);
+    char *text = (char *) malloc (len);
+    if (!text) len = 0;
+    len = fread (text, 1, len, f);
+    fclose (f);
+
+    run_all (argv[1], text, len, iterations);
+
+    free (text);
+    return 0;
+  }
+
+  /* Repeat each built-in sample to 64kb. */
+  const unsigned int len = 65536;
+  char *text = (char *) malloc (len);
+  if (!text)
+    return 1;
+  for (unsigned int i = 0; i < sizeof (corpora) / sizeof (corpora[0]); i++)
+  {
+    unsigned int sample_len = strlen (corpora[i][1]);
+    unsigned int l = 0;
+    while (l + sample_len <= len)
+    {
+      memcpy (text + l, corpora[i][1], sample_len);
+      l += sample_len;
+    }
+    run_all (corpora[i][0], text, l, iterations);
+  }
+  free (text);
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright © 2026  agent
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ * Author(s): agent
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "hb.h"
+#include "hb-ot.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef HAVE_FREETYPE
+#include "hb-ft.h"
+#endif
+
+/* Shapes long Arabic and Devanagari runs.  Most lookups of these
+ * scripts only apply to the glyphs that have one of their features
+ * (init, medi, fina, half, pres, ...), so the time is dominated by
+ * how quickly apply_forward() gets past the other glyphs. */
+
+static const char arabic[] = "\xd9\x81\xd9\x8a \xd8\xa7\xd9\x84\xd8\xa8\xd8\xaf\xd8\xa1 \xd8\xae\xd9\x84\xd9\x82 \xd8\xa7\xd9\x84\xd9\x84\xd9\x87 "
+			     "\xd8\xa7\xd9\x84\xd8\xb3\xd9\x85\xd8\xa7\xd9\x88\xd8\xa7\xd8\xaa \xd9\x88\xd8\xa7\xd9\x84\xd8\xa3\xd8\xb1\xd8\xb6 ";
+static const char devanagari[] = "\xe0\xa4\xb9\xe0\xa4\xbf\xe0\xa4\xa8\xe0\xa5\x8d\xe0\xa4\xa6\xe0\xa5\x80 "
+				 "\xe0\xa4\xaa\xe0\xa5\x8d\xe0\xa4\xb0\xe0\xa4\xa4\xe0\xa4\xbf\xe0\xa4\xb7\xe0\xa5\x8d\xe0\xa4\xa0\xe0\xa4\xbe "
+				 "\xe0\xa4\x95\xe0\xa5\x8d\xe0\xa4\xb7\xe0\xa4\xa4\xe0\xa5\x8d\xe0\xa4\xb0\xe0\xa4\xbf\xe0\xa4\xaf ";
+
+static void
+run (hb_font_t *font, const char *name, const char *text,
+     hb_script_t script, hb_direction_t direction,
+     unsigned int len, unsigned int iterations)
+{
+  hb_buffer_t *buffer = hb_buffer_create ();
+  unsigned int text_len = strlen (text);
+  unsigned int glyphs = 0;
+
+  clock_t start = clock ();
+  for (unsigned int i = 0; i < iterations; i++)
+  {
+    hb_buffer_clear_contents (buffer);
+    for (unsigned int j = 0; j < len; j += text_len)
+      hb_buffer_add_utf8 (buffer, text, text_len, 0, text_len);
+    hb_buffer_set_script (buffer, script);
+    hb_buffer_set_direction (buffer, direction);
+    hb_shape (font, buffer, NULL, 0);
+    glyphs += hb_buffer_get_length (buffer);
+  }
+  double ms = (clock () - start) * 1000. / CLOCKS_PER_SEC;
+
+  printf ("%-10s %9.2fms  %7.1fns/glyph\n",
+	  name, ms, glyphs ? ms * 1e6 / glyphs : 0.);
+
+  hb_buffer_destroy (buffer);
+}
+
+int
+main (int argc, char **argv)
+{
+  hb_blob_t *blob = NULL;
+
+  if (argc != 2 && argc != 3) {
+    fprintf (stderr, "usage: %s font-file [iterations]\n", argv[0]);
+    exit (1);
+  }
+
+  unsigned int iterations = argc > 2 ? strtol (argv[2], NULL, 0) : 100;
+
+  /* Create the blob */
+  {
+    const char *font_data;
+    unsigned int len;
+
+    FILE *f = fopen (argv[1], "rb");
+    if (!f) {
+      fprintf (stderr, "cannot open %s\n", argv[1]);
+      exit (1);
+    }
+    fseek (f, 0, SEEK_END);
+    len = ftell (f);
+    fseek (f, 0, SEEK_SET);
+    font_data = (const char *) malloc (len);
+    if (!font_data) len = 0;
+    len = fread ((char *) font_data, 1, len, f);
+    fclose (f);
+
+    blob = hb_blob_create (font_data, len, HB_MEMORY_MODE_WRITABLE, (void *) font_data, free);
+  }
+
+  /* Create the face and font */
+  hb_face_t *face = hb_face_create (blob, 0 /* first face */);
+  hb_blob_destroy (blob);
+  blob = NULL;
+
+  hb_font_t *font = hb_font_create (face);
+  unsigned int upem = hb_face_get_upem (face);
+  hb_font_set_scale (font, upem, upem);
+#ifdef HAVE_FREETYPE
+  hb_ft_font_set_funcs (font);
+#else
+  hb_ot_font_set_funcs (font);
+#endif
+
+  const unsigned int len = 16384; /* Bytes of UTF-8 per run. */
+  run (font, "Arabic", arabic, HB_SCRIPT_ARABIC, HB_DIRECTION_RTL, len, iterations);
+  run (font, "Devanagari", devanagari, HB_SCRIPT_DEVANAGARI, HB_DIRECTION_LTR, len, iterations);
+
+  hb_font_destroy (font);
+  hb_face_destroy (face);
+
+  return 0;
+}
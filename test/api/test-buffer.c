@@ -811,6 +811,63 @@ test_buffer_utf32_conversion (void)
 }
 
 
+/* Long runs of ASCII or BMP text are added in bulk; make sure an
+ * ill-formed sequence anywhere in them is still replaced in place. */
+static void
+test_buffer_utf_runs (void)
+{
+  hb_buffer_t *b;
+  char utf8[150];
+  uint16_t utf16[150];
+  unsigned int i, j, len;
+  hb_glyph_info_t *glyphs;
+
+  b = hb_buffer_create ();
+  hb_buffer_set_replacement_codepoint (b, (hb_codepoint_t) -1);
+
+  for (i = 0; i < G_N_ELEMENTS (utf8); i++)
+  {
+    g_test_message ("UTF-8 run test #%d", i);
+
+    for (j = 0; j < G_N_ELEMENTS (utf8); j++)
+      utf8[j] = 'a' + j % 26;
+    utf8[i] = '\303';
+
+    hb_buffer_clear_contents (b);
+    hb_buffer_add_utf8 (b, utf8, G_N_ELEMENTS (utf8), 0, -1);
+
+    glyphs = hb_buffer_get_glyph_infos (b, &len);
+    g_assert_cmpint (len, ==, G_N_ELEMENTS (utf8));
+    for (j = 0; j < len; j++)
+    {
+      g_assert_cmpint (glyphs[j].cluster, ==, j);
+      g_assert_cmphex (glyphs[j].codepoint, ==, j == i ? (hb_codepoint_t) -1 : 'a' + j % 26);
+    }
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (utf16); i++)
+  {
+    g_test_message ("UTF-16 run test #%d", i);
+
+    for (j = 0; j < G_N_ELEMENTS (utf16); j++)
+      utf16[j] = 0x0400 + j;
+    utf16[i] = 0xD800;
+
+    hb_buffer_clear_contents (b);
+    hb_buffer_add_utf16 (b, utf16, G_N_ELEMENTS (utf16), 0, -1);
+
+    glyphs = hb_buffer_get_glyph_infos (b, &len);
+    g_assert_cmpint (len, ==, G_N_ELEMENTS (utf16));
+    for (j = 0; j < len; j++)
+    {
+      g_assert_cmpint (glyphs[j].cluster, ==, j);
+      g_assert_cmphex (glyphs[j].codepoint, ==, j == i ? (hb_codepoint_t) -1 : 0x0400 + j);
+    }
+  }
+
+  hb_buffer_destroy (b);
+}
+
 static void
 test_empty (hb_buffer_t *b)
 {
@@ -878,6 +935,7 @@ main (int argc, char **argv)
   hb_test_add (test_buffer_utf8_validity);
   hb_test_add (test_buffer_utf16_conversion);
   hb_test_add (test_buffer_utf32_conversion);
+  hb_test_add (test_buffer_utf_runs);
   hb_test_add (test_buffer_empty);
 
   return hb_test_run();
@@ -210,6 +210,33 @@ test_types_language (void)
   g_assert (HB_LANGUAGE_INVALID != hb_language_get_default ());
 }
 
+static void
+test_types_language_many (void)
+{
+  char s[16];
+  unsigned int i, count;
+  hb_language_t langs[2000];
+
+  /* Enough languages to overflow the hash table's probe windows. */
+  count = hb_language_get_count ();
+  for (i = 0; i < 2000; i++)
+  {
+    snprintf (s, sizeof (s), "x-test-%u", i);
+    langs[i] = hb_language_from_string (s, -1);
+    g_assert (langs[i] != HB_LANGUAGE_INVALID);
+    g_assert (0 == strcmp (s, hb_language_to_string (langs[i])));
+  }
+  g_assert_cmpuint (hb_language_get_count (), ==, count + 2000);
+
+  /* Test recall */
+  for (i = 0; i < 2000; i++)
+  {
+    snprintf (s, sizeof (s), "X_TEST_%u", i);
+    g_assert (langs[i] == hb_language_from_string (s, -1));
+  }
+  g_assert_cmpuint (hb_language_get_count (), ==, count + 2000);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -220,6 +247,7 @@ main (int argc, char **argv)
   hb_test_add (test_types_tag);
   hb_test_add (test_types_script);
   hb_test_add (test_types_language);
+  hb_test_add (test_types_language_many);
 
   return hb_test_run();
 }
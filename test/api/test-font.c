@@ -61,6 +61,42 @@ test_face_create (void)
   hb_face_destroy (face);
 }
 
+static void
+test_face_layout_table_cache_budget (void)
+{
+  hb_face_t *face;
+  hb_font_t *font;
+  hb_buffer_t *buffer;
+  hb_blob_t *blob;
+
+  blob = hb_blob_create (test_data, sizeof (test_data), HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = hb_face_create (blob, 0);
+  hb_blob_destroy (blob);
+
+  g_assert_cmpuint (hb_face_get_layout_table_cache_budget (face), ==, 0);
+  hb_face_set_layout_table_cache_budget (face, 65536);
+  g_assert_cmpuint (hb_face_get_layout_table_cache_budget (face), ==, 65536);
+
+  /* A face without layout tables has nothing to materialize. */
+  font = hb_font_create (face);
+  buffer = hb_buffer_create ();
+  hb_buffer_add_utf8 (buffer, "test", -1, 0, -1);
+  hb_buffer_guess_segment_properties (buffer);
+  hb_shape (font, buffer, NULL, 0);
+  g_assert_cmpuint (hb_buffer_get_length (buffer), ==, 4);
+  hb_buffer_destroy (buffer);
+  hb_font_destroy (font);
+
+  /* The budget is fixed once the face is immutable. */
+  g_assert (hb_face_is_immutable (face));
+  hb_face_set_layout_table_cache_budget (face, 0);
+  g_assert_cmpuint (hb_face_get_layout_table_cache_budget (face), ==, 65536);
+
+  g_assert_cmpuint (hb_face_get_layout_table_cache_budget (hb_face_get_empty ()), ==, 0);
+
+  hb_face_destroy (face);
+}
+
 
 static void
 free_up (void *user_data)
@@ -481,6 +517,208 @@ test_font_properties (void)
   hb_font_destroy (subfont);
 }
 
+static unsigned int cache_glyph_calls;
+static unsigned int cache_advance_calls;
+
+static hb_bool_t
+cache_glyph_func (hb_font_t *font, void *font_data,
+		  hb_codepoint_t unicode, hb_codepoint_t variation_selector,
+		  hb_codepoint_t *glyph,
+		  void *user_data)
+{
+  cache_glyph_calls++;
+  if (unicode < 'a' || unicode > 'z')
+    return FALSE;
+  *glyph = unicode - 'a' + 1 + (variation_selector ? 100 : 0);
+  return TRUE;
+}
+
+static hb_position_t
+cache_advance_func (hb_font_t *font, void *font_data,
+		    hb_codepoint_t glyph,
+		    void *user_data)
+{
+  int x_scale;
+  cache_advance_calls++;
+  hb_font_get_scale (font, &x_scale, NULL);
+  return glyph * x_scale;
+}
+
+static void
+test_font_cache (void)
+{
+  hb_face_t *face;
+  hb_font_t *font;
+  hb_font_funcs_t *ffuncs;
+  hb_codepoint_t glyph;
+  unsigned int glyph_hits, glyph_misses, advance_hits, advance_misses;
+  unsigned int i;
+
+  face = hb_face_create (NULL, 0);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_font_set_scale (font, 10, 10);
+
+  ffuncs = hb_font_funcs_create ();
+  hb_font_funcs_set_glyph_func (ffuncs, cache_glyph_func, NULL, NULL);
+  hb_font_funcs_set_glyph_h_advance_func (ffuncs, cache_advance_func, NULL, NULL);
+  hb_font_set_funcs (font, ffuncs, NULL, NULL);
+  hb_font_funcs_destroy (ffuncs);
+
+  g_assert (!hb_font_get_cache_enabled (font));
+  glyph_hits = glyph_misses = advance_hits = advance_misses = 13;
+  hb_font_get_cache_stats (font, &glyph_hits, &glyph_misses, &advance_hits, &advance_misses);
+  g_assert_cmpuint (glyph_hits, ==, 0);
+  g_assert_cmpuint (glyph_misses, ==, 0);
+  g_assert_cmpuint (advance_hits, ==, 0);
+  g_assert_cmpuint (advance_misses, ==, 0);
+
+  hb_font_set_cache_enabled (font, TRUE);
+  g_assert (hb_font_get_cache_enabled (font));
+
+  cache_glyph_calls = cache_advance_calls = 0;
+  for (i = 0; i < 10; i++)
+  {
+    g_assert (hb_font_get_glyph (font, 'c', 0, &glyph));
+    g_assert_cmpuint (glyph, ==, 3);
+    g_assert_cmpint (hb_font_get_glyph_h_advance (font, glyph), ==, 30);
+    g_assert (!hb_font_get_glyph (font, '0', 0, &glyph));
+    g_assert_cmpuint (glyph, ==, 0);
+  }
+  g_assert_cmpuint (cache_glyph_calls, ==, 1 + 10);
+  g_assert_cmpuint (cache_advance_calls, ==, 1);
+
+  /* Variation-selector lookups bypass the cache. */
+  g_assert (hb_font_get_glyph (font, 'c', 0xFE00, &glyph));
+  g_assert_cmpuint (glyph, ==, 103);
+  g_assert (hb_font_get_glyph (font, 'c', 0, &glyph));
+  g_assert_cmpuint (glyph, ==, 3);
+
+  hb_font_get_cache_stats (font, NULL, NULL, NULL, NULL);
+  hb_font_get_cache_stats (font, &glyph_hits, &glyph_misses, &advance_hits, &advance_misses);
+  g_assert_cmpuint (glyph_hits, ==, 10);
+  g_assert_cmpuint (glyph_misses, ==, 11);
+  g_assert_cmpuint (advance_hits, ==, 9);
+  g_assert_cmpuint (advance_misses, ==, 1);
+
+  /* Changing the scale must invalidate cached advances. */
+  hb_font_set_scale (font, 20, 20);
+  g_assert_cmpint (hb_font_get_glyph_h_advance (font, 3), ==, 60);
+  g_assert_cmpint (hb_font_get_glyph_h_advance (font, 3), ==, 60);
+  g_assert_cmpuint (cache_advance_calls, ==, 2);
+
+  /* Out-of-range values are never cached. */
+  g_assert_cmpint (hb_font_get_glyph_h_advance (font, 0x10000), ==, 0x10000 * 20);
+  g_assert_cmpint (hb_font_get_glyph_h_advance (font, 0x10000), ==, 0x10000 * 20);
+  g_assert_cmpuint (cache_advance_calls, ==, 4);
+
+  hb_font_set_cache_enabled (font, FALSE);
+  g_assert (!hb_font_get_cache_enabled (font));
+  g_assert_cmpint (hb_font_get_glyph_h_advance (font, 3), ==, 60);
+  g_assert_cmpuint (cache_advance_calls, ==, 5);
+
+  hb_font_make_immutable (font);
+  hb_font_set_cache_enabled (font, TRUE);
+  g_assert (!hb_font_get_cache_enabled (font));
+
+  hb_font_destroy (font);
+}
+
+static unsigned int batch_advances_calls;
+
+static void
+batch_advances_func (hb_font_t *font, void *font_data,
+		     unsigned int count,
+		     const hb_codepoint_t *first_glyph,
+		     unsigned int glyph_stride,
+		     hb_position_t *first_advance,
+		     unsigned int advance_stride,
+		     void *user_data)
+{
+  unsigned int i;
+  batch_advances_calls++;
+  for (i = 0; i < count; i++)
+  {
+    *first_advance = -(hb_position_t) *first_glyph;
+    first_glyph = (const hb_codepoint_t *) ((const char *) first_glyph + glyph_stride);
+    first_advance = (hb_position_t *) ((char *) first_advance + advance_stride);
+  }
+}
+
+static void
+test_font_batch (void)
+{
+  hb_face_t *face;
+  hb_font_t *font;
+  hb_font_funcs_t *ffuncs;
+  hb_codepoint_t text[6] = {'a', 'b', 'c', '0', 'd', 'e'};
+  hb_codepoint_t glyphs[6] = {0, 0, 0, 0, 0, 0};
+  hb_glyph_info_t info[3];
+  hb_glyph_position_t pos[3];
+
+  face = hb_face_create (NULL, 0);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_font_set_scale (font, 10, 10);
+
+  ffuncs = hb_font_funcs_create ();
+  hb_font_funcs_set_glyph_func (ffuncs, cache_glyph_func, NULL, NULL);
+  hb_font_funcs_set_glyph_h_advance_func (ffuncs, cache_advance_func, NULL, NULL);
+  hb_font_set_funcs (font, ffuncs, NULL, NULL);
+
+  /* Without batch callbacks, the single-glyph ones are called in a loop. */
+  cache_glyph_calls = 0;
+  g_assert_cmpuint (hb_font_get_glyphs (font, 6, text, sizeof (text[0]), glyphs, sizeof (glyphs[0])), ==, 3);
+  g_assert_cmpuint (cache_glyph_calls, ==, 4);
+  g_assert_cmpuint (glyphs[0], ==, 1);
+  g_assert_cmpuint (glyphs[2], ==, 3);
+  g_assert_cmpuint (glyphs[4], ==, 0);
+  g_assert_cmpuint (hb_font_get_glyphs (font, 2, text + 4, sizeof (text[0]), glyphs, 2 * sizeof (glyphs[0])), ==, 2);
+  g_assert_cmpuint (glyphs[0], ==, 4);
+  g_assert_cmpuint (glyphs[2], ==, 5);
+  g_assert_cmpuint (hb_font_get_glyphs (font, 0, text, sizeof (text[0]), glyphs, sizeof (glyphs[0])), ==, 0);
+
+  memset (info, 0, sizeof (info));
+  memset (pos, 0, sizeof (pos));
+  info[0].codepoint = 1;
+  info[1].codepoint = 2;
+  info[2].codepoint = 3;
+  cache_advance_calls = 0;
+  hb_font_get_glyph_h_advances (font, 3,
+				&info[0].codepoint, sizeof (info[0]),
+				&pos[0].x_advance, sizeof (pos[0]));
+  g_assert_cmpuint (cache_advance_calls, ==, 3);
+  g_assert_cmpint (pos[0].x_advance, ==, 10);
+  g_assert_cmpint (pos[2].x_advance, ==, 30);
+  g_assert_cmpint (pos[2].y_advance, ==, 0);
+
+  /* The nil vertical callback gives the font's y_scale. */
+  hb_font_get_glyph_v_advances (font, 3,
+				&info[0].codepoint, sizeof (info[0]),
+				&pos[0].y_advance, sizeof (pos[0]));
+  g_assert_cmpint (pos[1].y_advance, ==, 10);
+
+  hb_font_destroy (font);
+
+  /* Batch callbacks take over once set. */
+  hb_font_funcs_set_glyph_h_advances_func (ffuncs, batch_advances_func, NULL, NULL);
+  face = hb_face_create (NULL, 0);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_font_set_funcs (font, ffuncs, NULL, NULL);
+  hb_font_funcs_destroy (ffuncs);
+
+  batch_advances_calls = cache_advance_calls = 0;
+  hb_font_get_glyph_h_advances (font, 3,
+				&info[0].codepoint, sizeof (info[0]),
+				&pos[0].x_advance, sizeof (pos[0]));
+  g_assert_cmpuint (batch_advances_calls, ==, 1);
+  g_assert_cmpuint (cache_advance_calls, ==, 0);
+  g_assert_cmpint (pos[1].x_advance, ==, -2);
+
+  hb_font_destroy (font);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -489,6 +727,7 @@ main (int argc, char **argv)
   hb_test_add (test_face_empty);
   hb_test_add (test_face_create);
   hb_test_add (test_face_createfortables);
+  hb_test_add (test_face_layout_table_cache_budget);
 
   hb_test_add (test_fontfuncs_empty);
   hb_test_add (test_fontfuncs_nil);
@@ -496,6 +735,8 @@ main (int argc, char **argv)
 
   hb_test_add (test_font_empty);
   hb_test_add (test_font_properties);
+  hb_test_add (test_font_cache);
+  hb_test_add (test_font_batch);
 
   return hb_test_run();
 }
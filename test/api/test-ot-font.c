@@ -0,0 +1,531 @@
+/*
+ * Copyright © 2026  agent
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ * Author(s): agent
+ */
+
+#include "hb-test.h"
+
+#include <hb-ot.h>
+
+/* Unit tests for hb-ot-font.h */
+
+
+/* A font with only a format-12 cmap mapping
+ * U+0041..U+005A -> 1..26, U+4E00..U+4E0F -> 100..115,
+ * and U+1F600..U+1F601 -> 200..201. */
+static const char cmap_font[] =
+  "\000\001\000\000\000\001\000\020"
+  "\000\000\000\000\143\155\141\160"
+  "\000\000\000\000\000\000\000\034"
+  "\000\000\000\100\000\000\000\001"
+  "\000\003\000\012\000\000\000\014"
+  "\000\014\000\000\000\000\000\064"
+  "\000\000\000\000\000\000\000\003"
+  "\000\000\000\101\000\000\000\132"
+  "\000\000\000\001\000\000\116\000"
+  "\000\000\116\017\000\000\000\144"
+  "\000\001\366\000\000\001\366\001"
+  "\000\000\000\310";
+
+/* A font with 1000 units per em and three glyphs: an empty .notdef,
+ * a simple 500x700 box at (10,0), and a composite of the box offset
+ * by (100,50).  The 'kern' table kerns the pair 1,2 by -50.  The
+ * version 2 'post' table names them .notdef, A, and box.comp. */
+static const char glyf_font[] =
+  "\000\001\000\000\000\010\000\200"
+  "\000\003\000\000\147\154\171\146"
+  "\000\000\000\000\000\000\000\214"
+  "\000\000\000\070\150\145\141\144"
+  "\000\000\000\000\000\000\000\304"
+  "\000\000\000\066\150\150\145\141"
+  "\000\000\000\000\000\000\000\374"
+  "\000\000\000\044\150\155\164\170"
+  "\000\000\000\000\000\000\001\040"
+  "\000\000\000\014\153\145\162\156"
+  "\000\000\000\000\000\000\001\054"
+  "\000\000\000\030\154\157\143\141"
+  "\000\000\000\000\000\000\001\104"
+  "\000\000\000\010\155\141\170\160"
+  "\000\000\000\000\000\000\001\114"
+  "\000\000\000\006\160\157\163\164"
+  "\000\000\000\000\000\000\001\124"
+  "\000\000\000\061\000\001\000\012"
+  "\000\000\001\376\002\274\000\003"
+  "\000\000\001\001\001\001\000\012"
+  "\000\000\001\364\000\000\000\000"
+  "\002\274\000\000\375\104\000\000"
+  "\377\377\000\156\000\062\002\142"
+  "\002\356\000\003\000\001\000\144"
+  "\000\062\000\000\000\001\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\137\017\074\365\000\000\003\350"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\012\000\000\002\142\002\356"
+  "\000\000\000\010\000\002\000\000"
+  "\000\000\000\000\000\001\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\003"
+  "\000\000\000\000\001\364\000\012"
+  "\002\130\000\156\000\000\000\001"
+  "\000\000\000\024\000\001\000\001"
+  "\000\006\000\000\000\000\000\001"
+  "\000\002\377\316\000\000\000\000"
+  "\000\022\000\034\000\000\120\000"
+  "\000\003\000\000\000\002\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\003\000\000"
+  "\000\044\001\002\010\142\157\170"
+  "\056\143\157\155\160\000\000\000";
+
+
+/* A font mapping U+0041 -> 1 whose glyphs 1..8 are each a composite of
+ * the next glyph sixteen times over, and glyph 9 is empty.  Its GPOS
+ * 'kern' feature has a CursivePosFormat1 for glyph 1 whose anchors are
+ * AnchorFormat2 at (100,200) with contour point 60000. */
+static const char nested_composite_font[] =
+  "\000\001\000\000\000\010\000\000"
+  "\000\000\000\000\107\120\117\123"
+  "\000\000\000\000\000\000\000\214"
+  "\000\000\000\120\143\155\141\160"
+  "\000\000\000\000\000\000\000\334"
+  "\000\000\000\050\147\154\171\146"
+  "\000\000\000\000\000\000\001\004"
+  "\000\000\003\120\150\145\141\144"
+  "\000\000\000\000\000\000\004\124"
+  "\000\000\000\066\150\150\145\141"
+  "\000\000\000\000\000\000\004\214"
+  "\000\000\000\044\150\155\164\170"
+  "\000\000\000\000\000\000\004\260"
+  "\000\000\000\050\154\157\143\141"
+  "\000\000\000\000\000\000\004\330"
+  "\000\000\000\026\155\141\170\160"
+  "\000\000\000\000\000\000\004\360"
+  "\000\000\000\040\000\001\000\000"
+  "\000\012\000\036\000\054\000\001"
+  "\104\106\114\124\000\010\000\004"
+  "\000\000\000\000\377\377\000\001"
+  "\000\000\000\001\153\145\162\156"
+  "\000\010\000\000\000\001\000\000"
+  "\000\001\000\004\000\003\000\000"
+  "\000\001\000\010\000\001\000\012"
+  "\000\001\000\020\000\020\000\001"
+  "\000\001\000\001\000\002\000\144"
+  "\000\310\352\140\000\000\000\001"
+  "\000\003\000\012\000\000\000\014"
+  "\000\014\000\000\000\000\000\034"
+  "\000\000\000\000\000\000\000\001"
+  "\000\000\000\101\000\000\000\101"
+  "\000\000\000\001\377\377\000\000"
+  "\000\000\000\000\000\000\000\042"
+  "\000\002\000\000\000\042\000\002"
+  "\000\000\000\042\000\002\000\000"
+  "\000\042\000\002\000\000\000\042"
+  "\000\002\000\000\000\042\000\002"
+  "\000\000\000\042\000\002\000\000"
+  "\000\042\000\002\000\000\000\042"
+  "\000\002\000\000\000\042\000\002"
+  "\000\000\000\042\000\002\000\000"
+  "\000\042\000\002\000\000\000\042"
+  "\000\002\000\000\000\042\000\002"
+  "\000\000\000\042\000\002\000\000"
+  "\000\002\000\002\000\000\377\377"
+  "\000\000\000\000\000\000\000\000"
+  "\000\042\000\003\000\000\000\042"
+  "\000\003\000\000\000\042\000\003"
+  "\000\000\000\042\000\003\000\000"
+  "\000\042\000\003\000\000\000\042"
+  "\000\003\000\000\000\042\000\003"
+  "\000\000\000\042\000\003\000\000"
+  "\000\042\000\003\000\000\000\042"
+  "\000\003\000\000\000\042\000\003"
+  "\000\000\000\042\000\003\000\000"
+  "\000\042\000\003\000\000\000\042"
+  "\000\003\000\000\000\042\000\003"
+  "\000\000\000\002\000\003\000\000"
+  "\377\377\000\000\000\000\000\000"
+  "\000\000\000\042\000\004\000\000"
+  "\000\042\000\004\000\000\000\042"
+  "\000\004\000\000\000\042\000\004"
+  "\000\000\000\042\000\004\000\000"
+  "\000\042\000\004\000\000\000\042"
+  "\000\004\000\000\000\042\000\004"
+  "\000\000\000\042\000\004\000\000"
+  "\000\042\000\004\000\000\000\042"
+  "\000\004\000\000\000\042\000\004"
+  "\000\000\000\042\000\004\000\000"
+  "\000\042\000\004\000\000\000\042"
+  "\000\004\000\000\000\002\000\004"
+  "\000\000\377\377\000\000\000\000"
+  "\000\000\000\000\000\042\000\005"
+  "\000\000\000\042\000\005\000\000"
+  "\000\042\000\005\000\000\000\042"
+  "\000\005\000\000\000\042\000\005"
+  "\000\000\000\042\000\005\000\000"
+  "\000\042\000\005\000\000\000\042"
+  "\000\005\000\000\000\042\000\005"
+  "\000\000\000\042\000\005\000\000"
+  "\000\042\000\005\000\000\000\042"
+  "\000\005\000\000\000\042\000\005"
+  "\000\000\000\042\000\005\000\000"
+  "\000\042\000\005\000\000\000\002"
+  "\000\005\000\000\377\377\000\000"
+  "\000\000\000\000\000\000\000\042"
+  "\000\006\000\000\000\042\000\006"
+  "\000\000\000\042\000\006\000\000"
+  "\000\042\000\006\000\000\000\042"
+  "\000\006\000\000\000\042\000\006"
+  "\000\000\000\042\000\006\000\000"
+  "\000\042\000\006\000\000\000\042"
+  "\000\006\000\000\000\042\000\006"
+  "\000\000\000\042\000\006\000\000"
+  "\000\042\000\006\000\000\000\042"
+  "\000\006\000\000\000\042\000\006"
+  "\000\000\000\042\000\006\000\000"
+  "\000\002\000\006\000\000\377\377"
+  "\000\000\000\000\000\000\000\000"
+  "\000\042\000\007\000\000\000\042"
+  "\000\007\000\000\000\042\000\007"
+  "\000\000\000\042\000\007\000\000"
+  "\000\042\000\007\000\000\000\042"
+  "\000\007\000\000\000\042\000\007"
+  "\000\000\000\042\000\007\000\000"
+  "\000\042\000\007\000\000\000\042"
+  "\000\007\000\000\000\042\000\007"
+  "\000\000\000\042\000\007\000\000"
+  "\000\042\000\007\000\000\000\042"
+  "\000\007\000\000\000\042\000\007"
+  "\000\000\000\002\000\007\000\000"
+  "\377\377\000\000\000\000\000\000"
+  "\000\000\000\042\000\010\000\000"
+  "\000\042\000\010\000\000\000\042"
+  "\000\010\000\000\000\042\000\010"
+  "\000\000\000\042\000\010\000\000"
+  "\000\042\000\010\000\000\000\042"
+  "\000\010\000\000\000\042\000\010"
+  "\000\000\000\042\000\010\000\000"
+  "\000\042\000\010\000\000\000\042"
+  "\000\010\000\000\000\042\000\010"
+  "\000\000\000\042\000\010\000\000"
+  "\000\042\000\010\000\000\000\042"
+  "\000\010\000\000\000\002\000\010"
+  "\000\000\377\377\000\000\000\000"
+  "\000\000\000\000\000\042\000\011"
+  "\000\000\000\042\000\011\000\000"
+  "\000\042\000\011\000\000\000\042"
+  "\000\011\000\000\000\042\000\011"
+  "\000\000\000\042\000\011\000\000"
+  "\000\042\000\011\000\000\000\042"
+  "\000\011\000\000\000\042\000\011"
+  "\000\000\000\042\000\011\000\000"
+  "\000\042\000\011\000\000\000\042"
+  "\000\011\000\000\000\042\000\011"
+  "\000\000\000\042\000\011\000\000"
+  "\000\042\000\011\000\000\000\002"
+  "\000\011\000\000\000\001\000\000"
+  "\000\001\000\000\000\000\000\000"
+  "\137\017\074\365\000\000\003\350"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\003\350\003\350"
+  "\000\000\000\010\000\002\000\000"
+  "\000\000\000\000\000\001\000\000"
+  "\003\040\377\070\000\000\001\364"
+  "\000\000\000\000\001\364\000\001"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\012"
+  "\001\364\000\000\001\364\000\000"
+  "\001\364\000\000\001\364\000\000"
+  "\001\364\000\000\001\364\000\000"
+  "\001\364\000\000\001\364\000\000"
+  "\001\364\000\000\001\364\000\000"
+  "\000\000\000\000\000\065\000\152"
+  "\000\237\000\324\001\011\001\076"
+  "\001\163\001\250\001\250\000\000"
+  "\000\001\000\000\000\012\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000"
+  "\000\000\000\000\000\000\000\000";
+
+static hb_font_t *
+create_font (const char *data, unsigned int length)
+{
+  hb_blob_t *blob;
+  hb_face_t *face;
+  hb_font_t *font;
+
+  blob = hb_blob_create (data, length, HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = hb_face_create (blob, 0);
+  hb_blob_destroy (blob);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_ot_font_set_funcs (font);
+
+  return font;
+}
+
+static hb_font_t *
+create_ot_font (void)
+{
+  return create_font (cmap_font, sizeof (cmap_font) - 1);
+}
+
+static void
+test_ot_font_cmap_budget (void)
+{
+  hb_font_t *font = create_ot_font ();
+  hb_font_t *flat_font = create_ot_font ();
+  hb_font_t *other;
+  hb_codepoint_t u, glyph, flat_glyph;
+
+  g_assert (!hb_ot_font_set_cmap_budget (flat_font, 0));
+  g_assert (!hb_ot_font_set_cmap_budget (flat_font, 64));
+  g_assert (hb_ot_font_set_cmap_budget (flat_font, 65536));
+
+  g_assert (hb_font_get_glyph (flat_font, 0x41, 0, &glyph));
+  g_assert_cmpuint (glyph, ==, 1);
+  g_assert (hb_font_get_glyph (flat_font, 0x4E0F, 0, &glyph));
+  g_assert_cmpuint (glyph, ==, 115);
+  g_assert (hb_font_get_glyph (flat_font, 0x1F601, 0, &glyph));
+  g_assert_cmpuint (glyph, ==, 201);
+  g_assert (!hb_font_get_glyph (flat_font, 0x1F602, 0, &glyph));
+  g_assert (!hb_font_get_glyph (flat_font, 0x10FFFF, 0, &glyph));
+  g_assert (!hb_font_get_glyph (flat_font, 0x110000, 0, &glyph));
+
+  for (u = 0; u < 0x20000; u++)
+  {
+    hb_bool_t ret, flat_ret;
+    glyph = flat_glyph = 13;
+    ret = hb_font_get_glyph (font, u, 0, &glyph);
+    flat_ret = hb_font_get_glyph (flat_font, u, 0, &flat_glyph);
+    g_assert_cmpint (ret, ==, flat_ret);
+    g_assert_cmpuint (glyph, ==, flat_glyph);
+  }
+
+  /* Fonts on the same face share the table. */
+  other = hb_font_create (hb_font_get_face (flat_font));
+  hb_ot_font_set_funcs (other);
+  g_assert (hb_ot_font_set_cmap_budget (other, 65536));
+  g_assert (!hb_ot_font_set_cmap_budget (other, 64));
+  g_assert (hb_font_get_glyph (other, 0x5A, 0, &glyph));
+  g_assert_cmpuint (glyph, ==, 26);
+  hb_font_destroy (other);
+
+  /* Only fonts using the OpenType functions, and only while mutable. */
+  other = hb_font_create (hb_font_get_face (font));
+  g_assert (!hb_ot_font_set_cmap_budget (other, 65536));
+  hb_font_destroy (other);
+  hb_font_make_immutable (font);
+  g_assert (!hb_ot_font_set_cmap_budget (font, 65536));
+
+  hb_font_destroy (font);
+  hb_font_destroy (flat_font);
+}
+
+static unsigned int table_requests[4];
+
+static hb_blob_t *
+count_table_requests (hb_face_t *face, hb_tag_t tag, void *user_data)
+{
+  switch (tag)
+  {
+    case HB_TAG ('c','m','a','p'): table_requests[0]++; break;
+    case HB_TAG ('h','m','t','x'): table_requests[1]++; break;
+    case HB_TAG ('v','m','t','x'): table_requests[2]++; break;
+    default:                       table_requests[3]++; break;
+  }
+  return NULL;
+}
+
+static void
+test_ot_font_lazy_tables (void)
+{
+  hb_face_t *face;
+  hb_font_t *font;
+  hb_codepoint_t glyph;
+
+  memset (table_requests, 0, sizeof (table_requests));
+  face = hb_face_create_for_tables (count_table_requests, NULL, NULL);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_ot_font_set_funcs (font);
+
+  /* Creating the font must not touch any table. */
+  g_assert_cmpuint (table_requests[0] + table_requests[1] + table_requests[2] + table_requests[3], ==, 0);
+
+  g_assert (!hb_font_get_glyph (font, 'A', 0, &glyph));
+  g_assert (!hb_font_get_glyph (font, 'B', 0, &glyph));
+  g_assert_cmpuint (table_requests[0], ==, 1);
+  g_assert_cmpuint (table_requests[1], ==, 0);
+
+  hb_font_get_glyph_h_advance (font, 0);
+  hb_font_get_glyph_h_advance (font, 1);
+  g_assert_cmpuint (table_requests[0], ==, 1);
+  g_assert_cmpuint (table_requests[1], ==, 1);
+  g_assert_cmpuint (table_requests[2], ==, 0);
+
+  hb_font_destroy (font);
+}
+
+static void
+test_ot_font_glyf (void)
+{
+  hb_font_t *font = create_font (glyf_font, sizeof (glyf_font) - 1);
+  hb_glyph_extents_t extents;
+  hb_position_t x, y;
+
+  hb_font_set_scale (font, 1000, 1000);
+
+  g_assert (hb_font_get_glyph_extents (font, 0, &extents));
+  g_assert_cmpint (extents.x_bearing, ==, 0);
+  g_assert_cmpint (extents.y_bearing, ==, 0);
+  g_assert_cmpint (extents.width, ==, 0);
+  g_assert_cmpint (extents.height, ==, 0);
+
+  g_assert (hb_font_get_glyph_extents (font, 1, &extents));
+  g_assert_cmpint (extents.x_bearing, ==, 10);
+  g_assert_cmpint (extents.y_bearing, ==, 700);
+  g_assert_cmpint (extents.width, ==, 500);
+  g_assert_cmpint (extents.height, ==, -700);
+
+  g_assert (hb_font_get_glyph_extents (font, 2, &extents));
+  g_assert_cmpint (extents.x_bearing, ==, 110);
+  g_assert_cmpint (extents.y_bearing, ==, 750);
+  g_assert (!hb_font_get_glyph_extents (font, 3, &extents));
+
+  g_assert (hb_font_get_glyph_contour_point (font, 1, 2, &x, &y));
+  g_assert_cmpint (x, ==, 510);
+  g_assert_cmpint (y, ==, 700);
+  g_assert (!hb_font_get_glyph_contour_point (font, 1, 4, &x, &y));
+  g_assert (hb_font_get_glyph_contour_point (font, 2, 0, &x, &y));
+  g_assert_cmpint (x, ==, 110);
+  g_assert_cmpint (y, ==, 50);
+  g_assert (!hb_font_get_glyph_contour_point (font, 0, 0, &x, &y));
+
+  g_assert_cmpint (hb_font_get_glyph_h_kerning (font, 1, 2), ==, -50);
+  g_assert_cmpint (hb_font_get_glyph_h_kerning (font, 2, 1), ==, 0);
+
+  hb_font_set_scale (font, 2000, 2000);
+  g_assert (hb_font_get_glyph_extents (font, 1, &extents));
+  g_assert_cmpint (extents.width, ==, 1000);
+  g_assert_cmpint (hb_font_get_glyph_h_kerning (font, 1, 2), ==, -100);
+
+  hb_font_destroy (font);
+
+  /* Fonts without outlines report nothing. */
+  font = create_ot_font ();
+  g_assert (!hb_font_get_glyph_extents (font, 1, &extents));
+  g_assert (!hb_font_get_glyph_contour_point (font, 1, 0, &x, &y));
+  g_assert_cmpint (hb_font_get_glyph_h_kerning (font, 1, 2), ==, 0);
+  hb_font_destroy (font);
+}
+
+static void
+test_ot_font_glyf_nested_composites (void)
+{
+  hb_font_t *font = create_font (nested_composite_font, sizeof (nested_composite_font) - 1);
+  hb_buffer_t *buffer;
+  hb_glyph_position_t *pos;
+  hb_position_t x, y;
+  unsigned int len;
+
+  hb_font_set_scale (font, 1000, 1000);
+  hb_font_set_ppem (font, 12, 12);
+
+  /* Walking every component to look for the point would take 16^8
+   * steps; give up well before that. */
+  g_assert (!hb_font_get_glyph_contour_point (font, 1, 60000, &x, &y));
+
+  /* And fall back to the anchor's design coordinates. */
+  buffer = hb_buffer_create ();
+  hb_buffer_add_utf8 (buffer, "AA", -1, 0, -1);
+  hb_buffer_guess_segment_properties (buffer);
+  hb_shape (font, buffer, NULL, 0);
+  pos = hb_buffer_get_glyph_positions (buffer, &len);
+  g_assert_cmpuint (len, ==, 2);
+  g_assert_cmpint (pos[0].x_advance, ==, 100);
+  g_assert_cmpint (pos[1].x_advance, ==, 400);
+  g_assert_cmpint (pos[1].x_offset, ==, -100);
+
+  hb_buffer_destroy (buffer);
+  hb_font_destroy (font);
+}
+
+static void
+test_ot_font_glyph_names (void)
+{
+  hb_font_t *font = create_font (glyf_font, sizeof (glyf_font) - 1);
+  hb_codepoint_t glyph;
+  char name[16];
+
+  g_assert (hb_font_get_glyph_name (font, 0, name, sizeof (name)));
+  g_assert_cmpstr (name, ==, ".notdef");
+  g_assert (hb_font_get_glyph_name (font, 1, name, sizeof (name)));
+  g_assert_cmpstr (name, ==, "A");
+  g_assert (hb_font_get_glyph_name (font, 2, name, sizeof (name)));
+  g_assert_cmpstr (name, ==, "box.comp");
+  g_assert (hb_font_get_glyph_name (font, 2, name, 4));
+  g_assert_cmpstr (name, ==, "box");
+  g_assert (!hb_font_get_glyph_name (font, 3, name, sizeof (name)));
+  g_assert_cmpstr (name, ==, "");
+
+  g_assert (hb_font_get_glyph_from_name (font, "box.comp", -1, &glyph));
+  g_assert_cmpuint (glyph, ==, 2);
+  g_assert (hb_font_get_glyph_from_name (font, "A.alt", 1, &glyph));
+  g_assert_cmpuint (glyph, ==, 1);
+  g_assert (hb_font_get_glyph_from_name (font, ".notdef", -1, &glyph));
+  g_assert_cmpuint (glyph, ==, 0);
+  g_assert (!hb_font_get_glyph_from_name (font, "box", -1, &glyph));
+  g_assert (!hb_font_get_glyph_from_name (font, "B", -1, &glyph));
+  g_assert (!hb_font_get_glyph_from_name (font, "", -1, &glyph));
+
+  g_assert (hb_font_glyph_from_string (font, "box.comp", -1, &glyph));
+  g_assert_cmpuint (glyph, ==, 2);
+
+  hb_font_destroy (font);
+
+  /* No 'post' table, no names. */
+  font = create_ot_font ();
+  g_assert (!hb_font_get_glyph_name (font, 1, name, sizeof (name)));
+  g_assert (!hb_font_get_glyph_from_name (font, "A", -1, &glyph));
+  hb_font_destroy (font);
+}
+
+int
+main (int argc, char **argv)
+{
+  hb_test_init (&argc, &argv);
+
+  hb_test_add (test_ot_font_cmap_budget);
+  hb_test_add (test_ot_font_lazy_tables);
+  hb_test_add (test_ot_font_glyf);
+  hb_test_add (test_ot_font_glyf_nested_composites);
+  hb_test_add (test_ot_font_glyph_names);
+
+  return hb_test_run();
+}
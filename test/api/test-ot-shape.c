@@ -0,0 +1,284 @@
+/*
+ * Copyright © 2026  agent
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ * Author(s): agent
+ */
+
+#include "hb-test.h"
+
+#include <hb-ot.h>
+
+/* Unit tests for hb-ot-shape.h */
+
+
+/* A font with a format-12 cmap mapping U+0041..U+005A -> 1..26, and a
+ * GSUB whose 'ccmp' feature has, in order, the lookups 28 -> 29,
+ * ligature 2 3 -> 28, and 1 -> 27.  Closing over "BC" thus takes more
+ * than one round. */
+static const char gsub_font[] =
+  "\000\001\000\000\000\002\000\000"
+  "\000\000\000\000\107\123\125\102"
+  "\000\000\000\000\000\000\000\054"
+  "\000\000\000\204\143\155\141\160"
+  "\000\000\000\000\000\000\000\260"
+  "\000\000\000\050\000\001\000\000"
+  "\000\012\000\036\000\060\000\001"
+  "\104\106\114\124\000\010\000\004"
+  "\000\000\000\000\377\377\000\001"
+  "\000\000\000\001\143\143\155\160"
+  "\000\010\000\000\000\003\000\000"
+  "\000\001\000\002\000\003\000\010"
+  "\000\036\000\076\000\001\000\000"
+  "\000\001\000\010\000\002\000\010"
+  "\000\001\000\035\000\001\000\001"
+  "\000\034\000\004\000\000\000\001"
+  "\000\010\000\001\000\022\000\001"
+  "\000\010\000\001\000\004\000\034"
+  "\000\002\000\003\000\001\000\001"
+  "\000\002\000\001\000\000\000\001"
+  "\000\010\000\002\000\010\000\001"
+  "\000\033\000\001\000\001\000\001"
+  "\000\000\000\001\000\003\000\012"
+  "\000\000\000\014\000\014\000\000"
+  "\000\000\000\034\000\000\000\000"
+  "\000\000\000\001\000\000\000\101"
+  "\000\000\000\132\000\000\000\001";
+
+
+/* A font with the same cmap, and a GPOS whose 'kern' feature has one
+ * PairPosFormat2 subtable.  Its Coverage and ClassDef1 are the same
+ * format-2 table, mapping glyphs 1, 3, ..., 15 to indices / classes
+ * 0..7; class 1 of ClassDef2 covers all glyphs, and class-1 glyph
+ * pairs kern by 10 * (class1 + 1).  The value records also have an
+ * XPlacement, so the subtable isn't compiled into a kern matrix. */
+static const char shared_table_font[] =
+  "\000\001\000\000\000\002\000\000"
+  "\000\000\000\000\107\120\117\123"
+  "\000\000\000\000\000\000\000\054"
+  "\000\000\000\306\143\155\141\160"
+  "\000\000\000\000\000\000\000\364"
+  "\000\000\000\050\000\001\000\000"
+  "\000\012\000\036\000\054\000\001"
+  "\104\106\114\124\000\010\000\004"
+  "\000\000\000\000\377\377\000\001"
+  "\000\000\000\001\153\145\162\156"
+  "\000\010\000\000\000\001\000\000"
+  "\000\001\000\004\000\002\000\000"
+  "\000\001\000\010\000\002\000\120"
+  "\000\005\000\000\000\120\000\204"
+  "\000\010\000\002\000\000\000\000"
+  "\000\000\000\012\000\000\000\000"
+  "\000\000\000\024\000\000\000\000"
+  "\000\000\000\036\000\000\000\000"
+  "\000\000\000\050\000\000\000\000"
+  "\000\000\000\062\000\000\000\000"
+  "\000\000\000\074\000\000\000\000"
+  "\000\000\000\106\000\000\000\000"
+  "\000\000\000\120\000\002\000\010"
+  "\000\001\000\001\000\000\000\003"
+  "\000\003\000\001\000\005\000\005"
+  "\000\002\000\007\000\007\000\003"
+  "\000\011\000\011\000\004\000\013"
+  "\000\013\000\005\000\015\000\015"
+  "\000\006\000\017\000\017\000\007"
+  "\000\002\000\001\000\001\000\032"
+  "\000\001\000\000\000\000\000\001"
+  "\000\003\000\012\000\000\000\014"
+  "\000\014\000\000\000\000\000\034"
+  "\000\000\000\000\000\000\000\001"
+  "\000\000\000\101\000\000\000\132"
+  "\000\000\000\001";
+
+
+static hb_font_t *
+create_font (void)
+{
+  hb_blob_t *blob;
+  hb_face_t *face;
+  hb_font_t *font;
+
+  blob = hb_blob_create (gsub_font, sizeof (gsub_font) - 1, HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = hb_face_create (blob, 0);
+  hb_blob_destroy (blob);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_ot_font_set_funcs (font);
+
+  return font;
+}
+
+static hb_buffer_t *
+create_buffer (const char *text)
+{
+  hb_buffer_t *buffer = hb_buffer_create ();
+
+  hb_buffer_add_utf8 (buffer, text, -1, 0, -1);
+  hb_buffer_guess_segment_properties (buffer);
+
+  return buffer;
+}
+
+static void
+assert_glyphs (hb_set_t *set, unsigned int count, const hb_codepoint_t *glyphs)
+{
+  hb_set_t *expected = hb_set_create ();
+  unsigned int i;
+
+  for (i = 0; i < count; i++)
+    hb_set_add (expected, glyphs[i]);
+  g_assert (hb_set_is_equal (set, expected));
+
+  hb_set_destroy (expected);
+}
+
+static void
+test_ot_shape_glyphs_closure (void)
+{
+  static const hb_codepoint_t abc[] = {1, 2, 3, 27, 28, 29};
+  hb_font_t *font = create_font ();
+  hb_buffer_t *buffer = create_buffer ("ABC");
+  hb_set_t *glyphs = hb_set_create ();
+
+  hb_ot_shape_glyphs_closure (font, buffer, NULL, 0, glyphs);
+  assert_glyphs (glyphs, G_N_ELEMENTS (abc), abc);
+
+  hb_set_destroy (glyphs);
+  hb_buffer_destroy (buffer);
+  hb_font_destroy (font);
+}
+
+static void
+test_ot_shape_closure (void)
+{
+  static const hb_codepoint_t a[] = {1, 27};
+  static const hb_codepoint_t b[] = {2};
+  static const hb_codepoint_t c[] = {3, 28, 29};
+  static const hb_codepoint_t abc[] = {1, 2, 3, 27, 28, 29};
+  hb_font_t *font = create_font ();
+  hb_buffer_t *buffer = create_buffer ("A");
+  hb_segment_properties_t props;
+  hb_ot_shape_closure_t *closure;
+  hb_set_t *new_glyphs = hb_set_create ();
+  hb_set_t *glyphs = hb_set_create ();
+
+  hb_buffer_get_segment_properties (buffer, &props);
+  closure = hb_ot_shape_closure_create (font, &props, NULL, 0);
+  g_assert (closure != hb_ot_shape_closure_get_empty ());
+
+  hb_ot_shape_closure_add_buffer (closure, buffer, new_glyphs);
+  assert_glyphs (new_glyphs, G_N_ELEMENTS (a), a);
+  hb_buffer_destroy (buffer);
+
+  buffer = create_buffer ("BA");
+  hb_set_clear (new_glyphs);
+  hb_ot_shape_closure_add_buffer (closure, buffer, new_glyphs);
+  assert_glyphs (new_glyphs, G_N_ELEMENTS (b), b);
+  hb_buffer_destroy (buffer);
+
+  buffer = create_buffer ("C");
+  hb_set_clear (new_glyphs);
+  hb_ot_shape_closure_add_buffer (closure, buffer, new_glyphs);
+  assert_glyphs (new_glyphs, G_N_ELEMENTS (c), c);
+
+  /* Adding nothing new adds no glyphs. */
+  hb_set_clear (new_glyphs);
+  hb_ot_shape_closure_add_buffer (closure, buffer, new_glyphs);
+  g_assert (hb_set_is_empty (new_glyphs));
+  hb_ot_shape_closure_add_buffer (closure, buffer, NULL);
+  hb_buffer_destroy (buffer);
+
+  hb_ot_shape_closure_get_glyphs (closure, glyphs);
+  assert_glyphs (glyphs, G_N_ELEMENTS (abc), abc);
+
+  hb_ot_shape_closure_destroy (closure);
+  hb_set_destroy (glyphs);
+  hb_set_destroy (new_glyphs);
+  hb_font_destroy (font);
+}
+
+static void
+test_ot_shape_closure_empty (void)
+{
+  hb_ot_shape_closure_t *closure = hb_ot_shape_closure_get_empty ();
+  hb_buffer_t *buffer = create_buffer ("ABC");
+  hb_set_t *glyphs = hb_set_create ();
+
+  hb_ot_shape_closure_add_buffer (closure, buffer, glyphs);
+  hb_ot_shape_closure_get_glyphs (closure, glyphs);
+  g_assert (hb_set_is_empty (glyphs));
+  hb_ot_shape_closure_destroy (closure);
+
+  hb_set_destroy (glyphs);
+  hb_buffer_destroy (buffer);
+}
+
+static void
+test_ot_shape_table_cache_shared_table (void)
+{
+  /* A table used as both Coverage and ClassDef must be looked up as
+   * each, whether or not the face materializes it. */
+  const char text[] = "ABCBEBGBIBKBMBOB";
+  unsigned int budget;
+
+  for (budget = 0; budget <= 1 << 20; budget += 1 << 20)
+  {
+    hb_blob_t *blob;
+    hb_face_t *face;
+    hb_font_t *font;
+    hb_buffer_t *buffer;
+    hb_glyph_position_t *pos;
+    unsigned int len, i;
+
+    blob = hb_blob_create (shared_table_font, sizeof (shared_table_font) - 1, HB_MEMORY_MODE_READONLY, NULL, NULL);
+    face = hb_face_create (blob, 0);
+    hb_blob_destroy (blob);
+    hb_face_set_layout_table_cache_budget (face, budget);
+    font = hb_font_create (face);
+    hb_font_set_scale (font, hb_face_get_upem (face), hb_face_get_upem (face));
+    hb_face_destroy (face);
+    hb_ot_font_set_funcs (font);
+
+    buffer = create_buffer (text);
+    hb_shape (font, buffer, NULL, 0);
+    pos = hb_buffer_get_glyph_positions (buffer, &len);
+    g_assert_cmpuint (len, ==, sizeof (text) - 1);
+    for (i = 0; i < len; i += 2)
+      g_assert_cmpint (pos[i].x_advance - pos[i + 1].x_advance, ==, 10 * (i / 2 + 1));
+
+    hb_buffer_destroy (buffer);
+    hb_font_destroy (font);
+  }
+}
+
+int
+main (int argc, char **argv)
+{
+  hb_test_init (&argc, &argv);
+
+  hb_test_add (test_ot_shape_glyphs_closure);
+  hb_test_add (test_ot_shape_closure);
+  hb_test_add (test_ot_shape_closure_empty);
+  hb_test_add (test_ot_shape_table_cache_shared_table);
+
+  return hb_test_run();
+}
@@ -205,6 +205,37 @@ test_set_iter (void)
   hb_set_destroy (s);
 }
 
+static void
+test_set_large (void)
+{
+  hb_codepoint_t next;
+  hb_set_t *s = hb_set_create ();
+
+  hb_set_add (s, 0x10FFFF);
+  hb_set_add_range (s, 0x1F600, 0x1F64F);
+  g_assert (hb_set_has (s, 0x10FFFF));
+  g_assert (hb_set_has (s, 0x1F610));
+  g_assert (!hb_set_has (s, 0xF610));
+  g_assert_cmpint (hb_set_get_population (s), ==, 81);
+  g_assert_cmpint (hb_set_get_min (s), ==, 0x1F600);
+  g_assert_cmpint (hb_set_get_max (s), ==, 0x10FFFF);
+
+  hb_set_del_range (s, 0x1F601, 0x1F64F);
+  g_assert_cmpint (hb_set_get_population (s), ==, 2);
+  next = 0x1F600;
+  g_assert (hb_set_next (s, &next));
+  g_assert_cmpint (next, ==, 0x10FFFF);
+
+  hb_set_clear (s);
+  hb_set_add_range (s, 0, 0x10FFFF);
+  g_assert_cmpint (hb_set_get_population (s), ==, 0x110000);
+  hb_set_invert (s);
+  g_assert (!hb_set_has (s, 0x10FFFF));
+  g_assert_cmpint (hb_set_get_min (s), ==, 0x110000);
+
+  hb_set_destroy (s);
+}
+
 static void
 test_set_empty (void)
 {
@@ -244,6 +275,7 @@ main (int argc, char **argv)
   hb_test_add (test_set_basic);
   hb_test_add (test_set_algebra);
   hb_test_add (test_set_iter);
+  hb_test_add (test_set_large);
   hb_test_add (test_set_empty);
 
   return hb_test_run();
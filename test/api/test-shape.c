@@ -138,6 +138,171 @@ test_shape (void)
   hb_font_destroy (font);
 }
 
+static void
+test_shape_codepoints (void)
+{
+  hb_blob_t *blob;
+  hb_face_t *face;
+  hb_font_funcs_t *ffuncs;
+  hb_font_t *font;
+  hb_buffer_t *buffer;
+  uint32_t storage[96];
+  const hb_codepoint_t text[] = {'x', 'T', 'e', 's', 'T', 'x'};
+  hb_codepoint_t glyphs[4];
+  uint32_t clusters[4];
+  hb_glyph_position_t positions[4];
+  unsigned int count, i;
+
+  blob = hb_blob_create (test_data, sizeof (test_data), HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = hb_face_create (blob, 0);
+  hb_blob_destroy (blob);
+  font = hb_font_create (face);
+  hb_face_destroy (face);
+  hb_font_set_scale (font, 10, 10);
+
+  ffuncs = hb_font_funcs_create ();
+  hb_font_funcs_set_glyph_h_advance_func (ffuncs, glyph_h_advance_func, NULL, NULL);
+  hb_font_funcs_set_glyph_func (ffuncs, glyph_func, NULL, NULL);
+  hb_font_funcs_set_glyph_h_kerning_func (ffuncs, glyph_h_kerning_func, NULL, NULL);
+  hb_font_set_funcs (font, ffuncs, NULL, NULL);
+  hb_font_funcs_destroy (ffuncs);
+
+  buffer = hb_buffer_create ();
+  g_assert (!hb_buffer_set_storage (buffer, storage, 8));
+  g_assert (hb_buffer_set_storage (buffer, storage, sizeof (storage)));
+  hb_buffer_set_direction (buffer, HB_DIRECTION_LTR);
+
+  count = G_N_ELEMENTS (glyphs);
+  g_assert_cmpuint (hb_shape_codepoints (font, buffer, NULL, 0,
+					 text, G_N_ELEMENTS (text), 1, 4,
+					 &count, glyphs, clusters, positions), ==, 4);
+  g_assert_cmpuint (count, ==, 4);
+  {
+    const hb_codepoint_t output_glyphs[] = {1, 2, 3, 1};
+    const hb_position_t output_x_advances[] = {9, 5, 5, 10};
+    const hb_position_t output_x_offsets[] = {0, -1, 0, 0};
+    for (i = 0; i < count; i++) {
+      g_assert_cmphex (glyphs[i], ==, output_glyphs[i]);
+      g_assert_cmpuint (clusters[i], ==, i + 1);
+      g_assert_cmpint (positions[i].x_advance, ==, output_x_advances[i]);
+      g_assert_cmpint (positions[i].x_offset, ==, output_x_offsets[i]);
+    }
+  }
+
+  /* The buffer holds the result, in the storage given to it. */
+  g_assert_cmpuint (hb_buffer_get_length (buffer), ==, 4);
+  g_assert ((void *) hb_buffer_get_glyph_infos (buffer, NULL) >= (void *) storage &&
+	    (void *) hb_buffer_get_glyph_infos (buffer, NULL) < (void *) (storage + G_N_ELEMENTS (storage)));
+  g_assert (!hb_buffer_set_storage (buffer, NULL, 0));
+
+  /* Short output arrays; segment properties are kept. */
+  count = 2;
+  g_assert_cmpuint (hb_shape_codepoints (font, buffer, NULL, 0,
+					 text, G_N_ELEMENTS (text), 1, -1,
+					 &count, glyphs, NULL, NULL), ==, 5);
+  g_assert_cmpuint (count, ==, 2);
+  g_assert_cmphex (glyphs[0], ==, 1);
+  g_assert_cmphex (glyphs[1], ==, 2);
+  g_assert_cmpint (hb_buffer_get_direction (buffer), ==, HB_DIRECTION_LTR);
+
+  /* Text that outgrows the storage moves to the heap. */
+  {
+    hb_codepoint_t long_text[100];
+    hb_codepoint_t long_glyphs[100];
+    for (i = 0; i < G_N_ELEMENTS (long_text); i++)
+      long_text[i] = TesT[i % 4];
+    count = G_N_ELEMENTS (long_glyphs);
+    g_assert_cmpuint (hb_shape_codepoints (font, buffer, NULL, 0,
+					   long_text, G_N_ELEMENTS (long_text), 0, -1,
+					   &count, long_glyphs, NULL, NULL), ==, 100);
+    for (i = 0; i < count; i++)
+      g_assert_cmphex (long_glyphs[i], ==, (i % 4 == 1) ? 2u : (i % 4 == 2) ? 3u : 1u);
+  }
+
+  hb_buffer_destroy (buffer);
+  hb_font_destroy (font);
+}
+
+static void
+test_shape_plan_cache (void)
+{
+  hb_blob_t *blob;
+  hb_face_t *face;
+  hb_shape_plan_t *plan1, *plan2, *plan3, *plan4;
+  hb_segment_properties_t props = HB_SEGMENT_PROPERTIES_DEFAULT;
+  hb_feature_t feature;
+  unsigned int num_plans, hits, misses, dropped;
+
+  blob = hb_blob_create (test_data, sizeof (test_data), HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = hb_face_create (blob, 0);
+  hb_blob_destroy (blob);
+  hb_face_set_shape_plan_cache_limit (face, 2);
+
+  props.direction = HB_DIRECTION_LTR;
+  props.script = HB_SCRIPT_LATIN;
+  plan1 = hb_shape_plan_create_cached (face, &props, NULL, 0, NULL);
+  plan2 = hb_shape_plan_create_cached (face, &props, NULL, 0, NULL);
+  g_assert (plan1 == plan2);
+
+  hb_feature_from_string ("-liga", -1, &feature);
+  plan3 = hb_shape_plan_create_cached (face, &props, &feature, 1, NULL);
+  g_assert (plan3 != plan1);
+
+  props.script = HB_SCRIPT_GREEK;
+  plan4 = hb_shape_plan_create_cached (face, &props, NULL, 0, NULL);
+  g_assert (plan4 != plan1 && plan4 != plan3);
+
+  hb_face_get_shape_plan_cache_stats (face, &num_plans, &hits, &misses, &dropped);
+  g_assert_cmpuint (num_plans, ==, 2);
+  g_assert_cmpuint (hits, ==, 1);
+  g_assert_cmpuint (misses, ==, 3);
+  g_assert_cmpuint (dropped, ==, 1);
+
+  hb_shape_plan_destroy (plan1);
+  hb_shape_plan_destroy (plan2);
+  hb_shape_plan_destroy (plan3);
+  hb_shape_plan_destroy (plan4);
+  hb_face_destroy (face);
+}
+
+static void
+test_shape_plan_cache_ranged_features (void)
+{
+  hb_blob_t *blob;
+  hb_face_t *face;
+  hb_shape_plan_t *plan1, *plan2, *plan3;
+  hb_segment_properties_t props = HB_SEGMENT_PROPERTIES_DEFAULT;
+  hb_feature_t feature;
+  unsigned int num_plans, hits;
+
+  blob = hb_blob_create (test_data, sizeof (test_data), HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = hb_face_create (blob, 0);
+  hb_blob_destroy (blob);
+
+  props.direction = HB_DIRECTION_LTR;
+  props.script = HB_SCRIPT_LATIN;
+
+  /* Plans only depend on whether a feature is global, not on its range. */
+  hb_feature_from_string ("liga[1:3]=0", -1, &feature);
+  plan1 = hb_shape_plan_create_cached (face, &props, &feature, 1, NULL);
+  hb_feature_from_string ("liga[5:7]=0", -1, &feature);
+  plan2 = hb_shape_plan_create_cached (face, &props, &feature, 1, NULL);
+  g_assert (plan1 == plan2);
+
+  hb_feature_from_string ("liga=0", -1, &feature);
+  plan3 = hb_shape_plan_create_cached (face, &props, &feature, 1, NULL);
+  g_assert (plan3 != plan1);
+
+  hb_face_get_shape_plan_cache_stats (face, &num_plans, &hits, NULL, NULL);
+  g_assert_cmpuint (num_plans, ==, 2);
+  g_assert_cmpuint (hits, ==, 1);
+
+  hb_shape_plan_destroy (plan1);
+  hb_shape_plan_destroy (plan2);
+  hb_shape_plan_destroy (plan3);
+  hb_face_destroy (face);
+}
+
 static void
 test_shape_list (void)
 {
@@ -157,8 +322,11 @@ main (int argc, char **argv)
   hb_test_init (&argc, &argv);
 
   hb_test_add (test_shape);
+  hb_test_add (test_shape_codepoints);
   /* TODO test fallback shaper */
   /* TODO test shaper_full */
+  hb_test_add (test_shape_plan_cache);
+  hb_test_add (test_shape_plan_cache_ranged_features);
   hb_test_add (test_shape_list);
 
   return hb_test_run();
@@ -781,6 +781,99 @@ test_unicode_script_roundtrip (gconstpointer user_data)
 }
 
 
+static const struct {
+  const char *text;
+  unsigned int num_runs;
+  struct { unsigned int start, length; hb_script_t script; hb_direction_t direction; } runs[3];
+} itemize_tests[] = {
+  {"", 0, {{0}}},
+  {"Hello, world!", 1, {{0, 13, HB_SCRIPT_LATIN, HB_DIRECTION_LTR}}},
+  /* Common text joins the preceding run; Inherited marks too. */
+  {"abc \xCE\xB1\xCE\xB2\xCC\x81", 2, {{0, 4, HB_SCRIPT_LATIN, HB_DIRECTION_LTR},
+				     {4, 6, HB_SCRIPT_GREEK, HB_DIRECTION_LTR}}},
+  {"abc \xCE\xB1\xCE\xB2\xCE\xB3 def", 3, {{0, 4, HB_SCRIPT_LATIN, HB_DIRECTION_LTR},
+					 {4, 7, HB_SCRIPT_GREEK, HB_DIRECTION_LTR},
+					 {11, 3, HB_SCRIPT_LATIN, HB_DIRECTION_LTR}}},
+  /* Leading Common text takes the first real script. */
+  {"123 \xD9\x85\xD8\xB1\xD8\xAD\xD8\xA8\xD8\xA7", 1, {{0, 14, HB_SCRIPT_ARABIC, HB_DIRECTION_RTL}}},
+  /* A closing bracket gets the script of its opening bracket. */
+  {"\xD7\xA9\xD7\x9C\xD7\x95\xD7\x9D (hello) \xD7\xA2\xD7\x95\xD7\x9C\xD7\x9D", 3,
+   {{0, 10, HB_SCRIPT_HEBREW, HB_DIRECTION_RTL},
+    {10, 5, HB_SCRIPT_LATIN, HB_DIRECTION_LTR},
+    {15, 10, HB_SCRIPT_HEBREW, HB_DIRECTION_RTL}}},
+  {"[\xCE\xB1\xCE\xB2] abc", 2, {{0, 7, HB_SCRIPT_GREEK, HB_DIRECTION_LTR},
+			      {7, 3, HB_SCRIPT_LATIN, HB_DIRECTION_LTR}}},
+};
+
+static void
+check_itemize (hb_unicode_funcs_t *uf)
+{
+  unsigned int i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (itemize_tests); i++)
+  {
+    hb_unicode_script_run_t runs[8];
+    unsigned int count = G_N_ELEMENTS (runs);
+
+    g_test_message ("Test itemize #%d", i);
+    g_assert_cmpuint (hb_unicode_script_itemize_utf8 (uf, itemize_tests[i].text, -1, 0, &count, runs), ==, itemize_tests[i].num_runs);
+    g_assert_cmpuint (count, ==, itemize_tests[i].num_runs);
+    for (j = 0; j < count; j++)
+    {
+      g_assert_cmpuint (runs[j].start, ==, itemize_tests[i].runs[j].start);
+      g_assert_cmpuint (runs[j].length, ==, itemize_tests[i].runs[j].length);
+      g_assert_cmphex (runs[j].script, ==, itemize_tests[i].runs[j].script);
+      g_assert_cmpint (runs[j].direction, ==, itemize_tests[i].runs[j].direction);
+    }
+  }
+
+  /* Windowed output. */
+  {
+    hb_unicode_script_run_t runs[1];
+    unsigned int count = 1;
+    g_assert_cmpuint (hb_unicode_script_itemize_utf8 (uf, itemize_tests[3].text, -1, 1, &count, runs), ==, 3);
+    g_assert_cmpuint (count, ==, 1);
+    g_assert_cmpuint (runs[0].start, ==, 4);
+    g_assert_cmphex (runs[0].script, ==, HB_SCRIPT_GREEK);
+    count = 1;
+    g_assert_cmpuint (hb_unicode_script_itemize_utf8 (uf, itemize_tests[3].text, -1, 3, &count, runs), ==, 3);
+    g_assert_cmpuint (count, ==, 0);
+    g_assert_cmpuint (hb_unicode_script_itemize_utf8 (uf, itemize_tests[3].text, -1, 0, NULL, NULL), ==, 3);
+  }
+
+  /* Offsets are in code units of the input. */
+  {
+    const uint16_t utf16[] = {'a', 'b', ' ', 0x03B1, 0xD835, 0xDEC2, 0};
+    const uint32_t utf32[] = {'a', 'b', ' ', 0x03B1, 0x1D6C2, 0};
+    hb_unicode_script_run_t runs[2];
+    unsigned int count = 2;
+
+    g_assert_cmpuint (hb_unicode_script_itemize_utf16 (uf, utf16, -1, 0, &count, runs), ==, 2);
+    g_assert_cmpuint (runs[1].start, ==, 3);
+    g_assert_cmpuint (runs[1].length, ==, 3);
+    g_assert_cmphex (runs[1].script, ==, HB_SCRIPT_GREEK);
+    count = 2;
+    g_assert_cmpuint (hb_unicode_script_itemize_utf32 (uf, utf32, -1, 0, &count, runs), ==, 2);
+    g_assert_cmpuint (runs[1].start, ==, 3);
+    g_assert_cmpuint (runs[1].length, ==, 2);
+  }
+}
+
+static void
+test_unicode_script_itemize (gconstpointer user_data)
+{
+  hb_unicode_funcs_t *uf = (hb_unicode_funcs_t *) user_data;
+  hb_unicode_funcs_t *child;
+
+  check_itemize (uf);
+
+  /* A subclass may override properties, and must be consulted. */
+  child = hb_unicode_funcs_create (uf);
+  check_itemize (child);
+  hb_unicode_funcs_destroy (child);
+}
+
+
 static void
 test_unicode_normalization (gconstpointer user_data)
 {
@@ -913,15 +1006,18 @@ main (int argc, char **argv)
 
   hb_test_add_data_flavor (hb_unicode_funcs_get_default (),          "default", test_unicode_properties);
   hb_test_add_data_flavor (hb_unicode_funcs_get_default (),          "default", test_unicode_normalization);
+  hb_test_add_data_flavor (hb_unicode_funcs_get_default (),          "default", test_unicode_script_itemize);
   hb_test_add_data_flavor ((gconstpointer) script_roundtrip_default, "default", test_unicode_script_roundtrip);
 #ifdef HAVE_GLIB
   hb_test_add_data_flavor (hb_glib_get_unicode_funcs (),             "glib",    test_unicode_properties);
   hb_test_add_data_flavor (hb_glib_get_unicode_funcs (),             "glib",    test_unicode_normalization);
+  hb_test_add_data_flavor (hb_glib_get_unicode_funcs (),             "glib",    test_unicode_script_itemize);
   hb_test_add_data_flavor ((gconstpointer) script_roundtrip_glib,    "glib",    test_unicode_script_roundtrip);
 #endif
 #ifdef HAVE_ICU
   hb_test_add_data_flavor (hb_icu_get_unicode_funcs (),              "icu",     test_unicode_properties);
   hb_test_add_data_flavor (hb_icu_get_unicode_funcs (),              "icu",     test_unicode_normalization);
+  hb_test_add_data_flavor (hb_icu_get_unicode_funcs (),              "icu",     test_unicode_script_itemize);
   hb_test_add_data_flavor ((gconstpointer) script_roundtrip_icu,     "icu",     test_unicode_script_roundtrip);
 #endif
 